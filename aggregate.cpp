@@ -0,0 +1,191 @@
+/**
+ * @file aggregate.cpp
+ * @brief Implementacja struktury `Aggregate`.
+ */
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AGGREGATE_SSE2 1
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define AGGREGATE_AVX 1
+#endif
+
+#include "aggregate.hpp"
+
+/**
+ * @brief Jądro agregacji jednej kolumny: dodaje sumę do `sum` i aktualizuje `min` i `max`.
+ */
+typedef void (*ColumnKernel)(const float* values, size_t count, double& sum, float& min, float& max);
+
+/**
+ * @brief Skalarne jądro agregacji kolumny.
+ */
+static void aggregateColumnScalar(const float* values, size_t count, double& sum, float& min, float& max) {
+    double total = 0.0;
+    float low = min;
+    float high = max;
+    for (size_t i = 0; i < count; ++i) {
+        total += values[i];
+        low = std::min(low, values[i]);
+        high = std::max(high, values[i]);
+    }
+    sum += total;
+    min = low;
+    max = high;
+}
+
+#ifdef AGGREGATE_SSE2
+/**
+ * @brief Jądro agregacji kolumny SSE2 (4 wartości na iterację, sumy w dwóch parach `double`).
+ */
+static void aggregateColumnSse2(const float* values, size_t count, double& sum, float& min, float& max) {
+    __m128d sumLow = _mm_setzero_pd();
+    __m128d sumHigh = _mm_setzero_pd();
+    __m128 low = _mm_set1_ps(min);
+    __m128 high = _mm_set1_ps(max);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 block = _mm_loadu_ps(values + i);
+        low = _mm_min_ps(low, block);
+        high = _mm_max_ps(high, block);
+        sumLow = _mm_add_pd(sumLow, _mm_cvtps_pd(block));
+        sumHigh = _mm_add_pd(sumHigh, _mm_cvtps_pd(_mm_movehl_ps(block, block)));
+    }
+
+    double sums[2];
+    float lows[4], highs[4];
+    _mm_storeu_pd(sums, _mm_add_pd(sumLow, sumHigh));
+    _mm_storeu_ps(lows, low);
+    _mm_storeu_ps(highs, high);
+
+    sum += sums[0] + sums[1];
+    for (int lane = 0; lane < 4; ++lane) {
+        min = std::min(min, lows[lane]);
+        max = std::max(max, highs[lane]);
+    }
+    aggregateColumnScalar(values + i, count - i, sum, min, max);
+}
+#endif
+
+#ifdef AGGREGATE_AVX
+/**
+ * @brief Jądro agregacji kolumny AVX (8 wartości na iterację, sumy w dwóch czwórkach `double`).
+ */
+__attribute__((target("avx")))
+static void aggregateColumnAvx(const float* values, size_t count, double& sum, float& min, float& max) {
+    __m256d sumLow = _mm256_setzero_pd();
+    __m256d sumHigh = _mm256_setzero_pd();
+    __m256 low = _mm256_set1_ps(min);
+    __m256 high = _mm256_set1_ps(max);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 block = _mm256_loadu_ps(values + i);
+        low = _mm256_min_ps(low, block);
+        high = _mm256_max_ps(high, block);
+        sumLow = _mm256_add_pd(sumLow, _mm256_cvtps_pd(_mm256_castps256_ps128(block)));
+        sumHigh = _mm256_add_pd(sumHigh, _mm256_cvtps_pd(_mm256_extractf128_ps(block, 1)));
+    }
+
+    double sums[4];
+    float lows[8], highs[8];
+    _mm256_storeu_pd(sums, _mm256_add_pd(sumLow, sumHigh));
+    _mm256_storeu_ps(lows, low);
+    _mm256_storeu_ps(highs, high);
+
+    sum += (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    for (int lane = 0; lane < 8; ++lane) {
+        min = std::min(min, lows[lane]);
+        max = std::max(max, highs[lane]);
+    }
+    aggregateColumnScalar(values + i, count - i, sum, min, max);
+}
+#endif
+
+/**
+ * @brief Wybiera najszybsze jądro agregacji obsługiwane przez procesor.
+ */
+static ColumnKernel selectColumnKernel() {
+#ifdef AGGREGATE_AVX
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) {
+        return aggregateColumnAvx;
+    }
+#endif
+#ifdef AGGREGATE_SSE2
+    return aggregateColumnSse2;
+#else
+    return aggregateColumnScalar;
+#endif
+}
+
+/**
+ * @brief Tworzy pusty agregat z minimum +inf i maksimum -inf.
+ */
+Aggregate::Aggregate() : count(0) {
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        sum[channel] = 0.0;
+        min[channel] = std::numeric_limits<float>::infinity();
+        max[channel] = -std::numeric_limits<float>::infinity();
+    }
+}
+
+/**
+ * @brief Dodaje pojedynczy rekord do agregatu.
+ * @param values Wartości kanałów rekordu.
+ */
+void Aggregate::add(const float values[CHANNEL_COUNT]) {
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        sum[channel] += values[channel];
+        min[channel] = std::min(min[channel], values[channel]);
+        max[channel] = std::max(max[channel], values[channel]);
+    }
+    ++count;
+}
+
+/**
+ * @brief Dodaje do agregatu ciągły zakres rekordów zapisanych kolumnowo.
+ * @param channels Kolumny wartości kanałów.
+ * @param begin Indeks pierwszego rekordu.
+ * @param end Indeks za ostatnim rekordem.
+ */
+void Aggregate::addColumns(const float* const channels[CHANNEL_COUNT], size_t begin, size_t end) {
+    static const ColumnKernel kernel = selectColumnKernel();
+
+    if (begin >= end) {
+        return;
+    }
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        kernel(channels[channel] + begin, end - begin, sum[channel], min[channel], max[channel]);
+    }
+    count += end - begin;
+}
+
+/**
+ * @brief Łączy agregat z innym agregatem.
+ * @param other Agregat do dołączenia.
+ */
+void Aggregate::merge(const Aggregate& other) {
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        sum[channel] += other.sum[channel];
+        min[channel] = std::min(min[channel], other.min[channel]);
+        max[channel] = std::max(max[channel], other.max[channel]);
+    }
+    count += other.count;
+}
+
+/**
+ * @brief Zwraca średnią wartość kanału.
+ * @param channel Kanał pomiarowy.
+ * @return Średnia lub 0, jeśli agregat jest pusty.
+ */
+double Aggregate::average(Channel channel) const {
+    return count > 0 ? sum[channel] / static_cast<double>(count) : 0.0;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file aggregate.hpp
+ * @brief Definicja struktury `Aggregate` przechowującej zagregowane statystyki kanałów.
+ */
+
+#ifndef AGGREGATE_HPP
+#define AGGREGATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "lineData.hpp"
+
+/**
+ * @struct Aggregate
+ * @brief Bieżące statystyki (suma, liczność, minimum, maksimum) dla wszystkich kanałów.
+ *
+ * Agregaty są utrzymywane w każdym węźle `TreeData`, dzięki czemu zapytania zakresowe
+ * mogą łączyć całe poddrzewa bez przeglądania pojedynczych rekordów. Sumy są liczone
+ * w `double`, aby uniknąć dryfu przy sumowaniu dużej liczby wartości `float`.
+ */
+struct Aggregate {
+    uint64_t count; /**< Liczba zagregowanych rekordów. */
+    double sum[CHANNEL_COUNT]; /**< Sumy wartości kanałów. */
+    float min[CHANNEL_COUNT]; /**< Minima wartości kanałów. */
+    float max[CHANNEL_COUNT]; /**< Maksima wartości kanałów. */
+
+    /**
+     * @brief Tworzy pusty agregat.
+     */
+    Aggregate();
+
+    /**
+     * @brief Dodaje pojedynczy rekord do agregatu.
+     * @param values Wartości kanałów rekordu (indeksowane `Channel`).
+     */
+    void add(const float values[CHANNEL_COUNT]);
+
+    /**
+     * @brief Dodaje do agregatu ciągły zakres rekordów zapisanych kolumnowo.
+     *
+     * Używa wektorowych jąder (AVX lub SSE2, wybieranych przy pierwszym wywołaniu zależnie
+     * od procesora) z akumulacją w `double`; na innych architekturach pętli skalarnej.
+     *
+     * @param channels Kolumny wartości kanałów (indeksowane `Channel`).
+     * @param begin Indeks pierwszego rekordu.
+     * @param end Indeks za ostatnim rekordem.
+     */
+    void addColumns(const float* const channels[CHANNEL_COUNT], size_t begin, size_t end);
+
+    /**
+     * @brief Łączy agregat z innym agregatem.
+     * @param other Agregat do dołączenia.
+     */
+    void merge(const Aggregate& other);
+
+    /**
+     * @brief Zwraca średnią wartość kanału.
+     * @param channel Kanał pomiarowy.
+     * @return Średnia lub 0, jeśli agregat jest pusty.
+     */
+    double average(Channel channel) const;
+
+    /**
+     * @brief Sprawdza, czy agregat nie zawiera rekordów.
+     */
+    bool empty() const { return count == 0; }
+};
+
+#endif
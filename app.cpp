@@ -1,12 +1,15 @@
+#include <atomic>
 #include <fstream>
+#include <thread>
 
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
 #include "app.hpp"
+#include "csvLoader.hpp"
 #include "lineData.hpp"
-#include "lineValidation.hpp"
+#include "threadPool.hpp"
 #include "treeData.hpp"
 #include "logger.hpp"
 
@@ -18,7 +21,10 @@ std::istream& operator>>(std::istream& iStream, MenuOption& menuOption) {
   return iStream;
 }
 
-TreeData App::treeData;
+TreeStore App::treeStore;
+FileFollower App::fileFollower("Chart Export.csv");
+std::thread App::follower;
+std::atomic<bool> App::followerStop(false);
 
 int App::mainMenu() {
   while (true) {
@@ -33,8 +39,9 @@ int App::mainMenu() {
     std::cout << "7. Wyszukaj dane w określonym przedziale czasowym z tolerancją\n";
     std::cout << "8. Zapisz dane do pliku binarnego\n";
     std::cout << "9. Wczytaj dane z pliku binarnego\n";
+    std::cout << (follower.joinable() ? "10. Zakończ śledzenie przyrostu pliku\n" : "10. Śledź przyrost pliku w tle\n");
 
-    std::cout << "10. Wyjdź\n\n";
+    std::cout << "11. Wyjdź\n\n";
 
     std::cout << "Wybierz działanie: ";
 
@@ -77,6 +84,9 @@ int App::mainMenu() {
     case LOAD_DATA_FROM_BINARY_FILE:
       handleLoadDataFromBinaryFile();
       break;
+    case FOLLOW_FILE:
+      handleFollowFile();
+      break;
     case EXIT: {
       return handleExit();
     }
@@ -100,43 +110,38 @@ int App::run() {
 }
 
 int App::handleLoadDataFromFile() {
-  std::ifstream file;
+  LoadStats stats;
 
-  file.open("Chart Export.csv");
-  if (!file.is_open()) {
+  // Wczytywane są tylko wiersze dopisane od poprzedniego wczytania
+  bool loaded = treeStore.update([&stats](TreeData& treeData) {
+    if (!fileFollower.poll(treeData, stats, ThreadPool::defaultThreadCount())) {
+      return false;
+    }
+    treeData.buildIndexes();
+    return true;
+  });
+  if (!loaded) {
     std::cerr << "Podczas otwierania pliku wystąpił błąd" << std::endl;
     return -1;
   }
 
-  vector<LineData> data;
-  std::string line;
-
-  while (std::getline(file, line)) {
-    if (lineValidation(line)) {
-      LineData ld(line);
-      data.push_back(ld);
-      treeData.addData(ld);
-    }
-  }
-
-  file.close();
   cout << "Dane zostały załadowane pomyślnie." << endl;
-  cout << "Załadowano " << data.size() << " linii" << endl;
-  cout << "Znaleziono " << loggerErrorCount << " niepoprawnych linii" << endl;
+  cout << "Załadowano " << stats.loadedLines << " linii" << endl;
+  cout << "Znaleziono " << stats.invalidLines << " niepoprawnych linii" << endl;
+  cout << "Pominięto " << stats.duplicateLines << " linii z datą już obecną w danych" << endl;
   cout << "Sprawdź pliki log i log_error, aby uzyskać więcej informacji" << endl;
 
   return 0;
 }
 
 int App::handleDisplayTreeStructure() {
-  treeData.print();
+  treeStore.snapshot()->print();
 
   return 0;
 }
 
 int App::handleGetDataBetweenDates() {
   std::string startDate, endDate;
-  std::vector<LineData> filteredData;
 
   std::cout << "Podaj datę początkową (dd.mm.yyyy hh:mm): ";
   std::cin.ignore();
@@ -144,11 +149,11 @@ int App::handleGetDataBetweenDates() {
   std::cout << "Podaj datę końcową (dd.mm.yyyy hh:mm): ";
   std::getline(std::cin, endDate);
 
-  filteredData = treeData.getDataBetweenDates(startDate, endDate);
   std::cout << "Dane pomiędzy " << startDate << " a " << endDate << ":" << std::endl;
-  for (const auto& ld : filteredData) {
-    ld.print();
-  }
+  treeStore.snapshot()->forEachBetweenDates(startDate, endDate, [](const RecordView& record) {
+    record.print(std::cout);
+  });
+  std::cout.flush();
 
   return 0;
 }
@@ -163,7 +168,7 @@ int App::handleCalculateSumsBetweenDates() {
   std::cout << "Podaj datę końcową (dd.mm.yyyy hh:mm): ";
   std::getline(std::cin, endDate);
 
-  treeData.calculateSumsBetweenDates(startDate, endDate, autokonsumpcjaSum, eksportSum, importSum, poborSum, produkcjaSum);
+  treeStore.snapshot()->calculateSumsBetweenDates(startDate, endDate, autokonsumpcjaSum, eksportSum, importSum, poborSum, produkcjaSum);
   std::cout << "Suma pomiędzy " << startDate << " and " << endDate << ":" << std::endl;
   std::cout << "Autokonsumpcja: " << autokonsumpcjaSum << std::endl;
   std::cout << "Eksport: " << eksportSum << std::endl;
@@ -184,7 +189,7 @@ int App::handleCalculateAveragesBetweenDates() {
   std::cout << "Podaj datę końcową (dd.mm.yyyy hh:mm): ";
   std::getline(std::cin, endDate);
 
-  treeData.calculateAveragesBetweenDates(startDate, endDate, autokonsumpcjaSum, eksportSum, importSum, poborSum, produkcjaSum);
+  treeStore.snapshot()->calculateAveragesBetweenDates(startDate, endDate, autokonsumpcjaSum, eksportSum, importSum, poborSum, produkcjaSum);
   std::cout << "Średnie wartości pomiędzy " << startDate << " a " << endDate << ":" << std::endl;
   std::cout << "Autokonsumpcja: " << autokonsumpcjaSum << std::endl;
   std::cout << "Eksport: " << eksportSum << std::endl;
@@ -208,7 +213,7 @@ int App::handleCompareDataBetweenDates() {
   std::cout << "Podaj drugą datę końcową (dd.mm.yyyy hh:mm): ";
   std::getline(std::cin, endDate2);
 
-  treeData.compareDataBetweenDates(startDate1, endDate1, startDate2, endDate2, autokonsumpcjaDiff, eksportDiff, importDiff, poborDiff, produkcjaDiff);
+  treeStore.snapshot()->compareDataBetweenDates(startDate1, endDate1, startDate2, endDate2, autokonsumpcjaDiff, eksportDiff, importDiff, poborDiff, produkcjaDiff);
   std::cout << "Różnicę pomiędzy " << startDate1 << " a " << endDate1 << " a " << startDate2 << " a " << endDate2 << ":" << std::endl;
   std::cout << "Autokonsumpcja: " << autokonsumpcjaDiff << std::endl;
   std::cout << "Eksport: " << eksportDiff << std::endl;
@@ -222,7 +227,7 @@ int App::handleCompareDataBetweenDates() {
 int App::handleSearchRecordsWithTolerance() {
   std::string startDate, endDate;
   float searchValue, tolerance;
-  std::vector<LineData> recordsWithTolerance;
+  int channelNumber;
 
   std::cout << "Podaj datę początkową (dd.mm.yyyy hh:mm): ";
   std::getline(std::cin, startDate);
@@ -232,17 +237,30 @@ int App::handleSearchRecordsWithTolerance() {
   std::cin >> searchValue;
   std::cout << "Podaj tolerancję: ";
   std::cin >> tolerance;
+  std::cout << "Podaj kanał (1 - autokonsumpcja, 2 - eksport, 3 - import, 4 - pobór, 5 - produkcja): ";
+  std::cin >> channelNumber;
 
-  recordsWithTolerance = treeData.searchRecordsWithTolerance(startDate, endDate, searchValue, tolerance);
-  std::cout << "Znalezione rekordy w zakresie tolerancji:" << std::endl;
-  for (const auto& ld : recordsWithTolerance) {
-    ld.print();
+  if (channelNumber < 1 || channelNumber > CHANNEL_COUNT) {
+    std::cout << "Nieprawidłowy kanał" << std::endl;
+    return -1;
   }
 
+  std::cout << "Znalezione rekordy w zakresie tolerancji:" << std::endl;
+  treeStore.snapshot()->forEachWithTolerance(startDate, endDate, searchValue, tolerance, static_cast<Channel>(channelNumber - 1),
+    [](const RecordView& record) {
+      record.print(std::cout);
+    });
+  std::cout.flush();
+
   return 0;
 }
 
 int App::handleSaveDataToBinaryFile() {
+  char answer;
+
+  std::cout << "Czy skompresować dane? (t/n): ";
+  std::cin >> answer;
+
   std::ofstream file;
   file.open("data.bin", std::ios::binary);
   if (!file.is_open()) {
@@ -250,7 +268,13 @@ int App::handleSaveDataToBinaryFile() {
     return -1;
   }
 
-  treeData.serialize(file);
+  try {
+    treeStore.snapshot()->serialize(file, answer == 't' || answer == 'T');
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+
   file.close();
   std::cout << "Dane zostały pomyślnie zapisane." << std::endl;
 
@@ -265,17 +289,78 @@ int App::handleLoadDataFromBinaryFile() {
     return -1;
   }
 
-  while (file.peek() != EOF) {
-    LineData ld(file);
+  // Uszkodzony plik zgłasza wyjątek przed opublikowaniem wersji, więc czytelnicy nie widzą części rekordów
+  size_t recordsLoaded = 0;
+  try {
+    treeStore.update([&file, &recordsLoaded](TreeData& treeData) {
+      size_t recordsBefore = treeData.size();
+      treeData.deserialize(file);
+      treeData.buildIndexes();
+      recordsLoaded = treeData.size() - recordsBefore;
+      return true;
+    });
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return -1;
   }
 
   file.close();
-  std::cout << "Dane zostały pomyślnie zapisane." << std::endl;
+  std::cout << "Dane zostały pomyślnie wczytane." << std::endl;
+  std::cout << "Wczytano " << recordsLoaded << " rekordów" << std::endl;
+
+  return 0;
+}
+
+int App::handleFollowFile() {
+  if (follower.joinable()) {
+    followerStop = true;
+    follower.join();
+    std::cout << "Zakończono śledzenie pliku." << std::endl;
+    return 0;
+  }
+
+  // Każde wczytanie publikuje nową wersję drzewa, a pozostałe opcje menu odpowiadają w tym czasie
+  // na podstawie ostatniej opublikowanej wersji
+  followerStop = false;
+  std::cout << "Śledzenie pliku " << fileFollower.getPath() << " w tle, wybierz ponownie opcję 10, aby zakończyć" << std::endl;
+  follower = std::thread([]() {
+    bool reported = false;
+    while (!followerStop) {
+      LoadStats stats;
+      bool failed = false;
+      treeStore.update([&stats, &failed](TreeData& treeData) {
+        if (!fileFollower.poll(treeData, stats, ThreadPool::defaultThreadCount())) {
+          failed = true;
+          return false;
+        }
+        if (stats.loadedLines == 0) {
+          return false;
+        }
+        treeData.buildIndexes();
+        return true;
+      });
+      if (failed) {
+        if (!reported) {
+          std::cerr << "Podczas otwierania pliku wystąpił błąd" << std::endl;
+          reported = true;
+        }
+      } else if (stats.loadedLines > 0 || stats.invalidLines > 0) {
+        std::cout << "Załadowano " << stats.loadedLines << " nowych linii, niepoprawnych: " << stats.invalidLines
+                  << ", zduplikowanych: " << stats.duplicateLines << ", rekordów łącznie: " << treeStore.snapshot()->size() << std::endl;
+        reported = false;
+      }
+      fileFollower.waitForChange(500);
+    }
+  });
 
   return 0;
 }
 
 int App::handleExit() {
+  if (follower.joinable()) {
+    followerStop = true;
+    follower.join();
+  }
   std::cout << "Dziękujemy za korzystanie z programu\n";
 
   return 0;
@@ -11,6 +11,7 @@
  * - Wyświetlanie danych w formie drzewa
  * - Przetwarzanie i analizowanie danych w różnych przedziałach czasowych
  * - Zapis i odczyt danych z plików binarnych
+ * - Przyrostowe wczytywanie wierszy dopisywanych do pliku CSV (w tle, równolegle z zapytaniami)
  *
  * ### Enumeracja `MenuOption`:
  * Wyliczenie definiuje dostępne opcje menu, takie jak:
@@ -23,6 +24,7 @@
  * - `SEARCH_RECORDS_WITH_TOLERANCE`: Wyszukaj dane w przedziale czasowym z tolerancją.
  * - `SAVE_DATA_TO_BINARY_FILE`: Zapisz dane do pliku binarnego.
  * - `LOAD_DATA_FROM_BINARY_FILE`: Wczytaj dane z pliku binarnego.
+ * - `FOLLOW_FILE`: Śledź przyrost pliku CSV.
  * - `EXIT`: Wyjdź z programu.
  *
  * ### Klasa `App`:
@@ -32,10 +34,13 @@
 #ifndef APP_HPP
 #define APP_HPP
 
+#include <atomic>
 #include <iostream>
+#include <thread>
 #include <vector>
 
-#include "treeData.hpp"
+#include "fileFollower.hpp"
+#include "treeStore.hpp"
 
 /**
  * @enum MenuOption
@@ -51,6 +56,7 @@ enum MenuOption {
   SEARCH_RECORDS_WITH_TOLERANCE,      ///< Wyszukaj dane w przedziale czasowym z tolerancją
   SAVE_DATA_TO_BINARY_FILE,           ///< Zapisz dane do pliku binarnego
   LOAD_DATA_FROM_BINARY_FILE,         ///< Wczytaj dane z pliku binarnego
+  FOLLOW_FILE,                        ///< Śledź przyrost pliku CSV
   EXIT                                ///< Wyjdź z programu
 };
 
@@ -71,7 +77,10 @@ std::istream& operator>>(std::istream& iStream, MenuOption& menuOption);
  */
 class App {
 private:
-  static TreeData treeData; ///< Statyczna instancja klasy `TreeData` przechowująca dane.
+  static TreeStore treeStore; ///< Opublikowane wersje drzewa; zapytania czytają bieżącą wersję w czasie wczytywania kolejnej.
+  static FileFollower fileFollower; ///< Pozycja wczytania pliku CSV, aby ponowne wczytanie nie dublowało danych.
+  static std::thread follower; ///< Wątek śledzący przyrost pliku CSV w tle (jeśli uruchomiony).
+  static std::atomic<bool> followerStop; ///< Prośba o zakończenie wątku `follower`.
 
   /**
    * @brief Konstruktor prywatny, aby uniemożliwić tworzenie instancji klasy `App`.
@@ -99,6 +108,7 @@ private:
   static int handleSearchRecordsWithTolerance();     ///< Wyszukuje dane z tolerancją
   static int handleSaveDataToBinaryFile();           ///< Zapisuje dane do pliku binarnego
   static int handleLoadDataFromBinaryFile();         ///< Wczytuje dane z pliku binarnego
+  static int handleFollowFile();                     ///< Włącza lub wyłącza wczytywanie w tle wierszy dopisywanych do pliku CSV
   static int handleExit();                           ///< Obsługuje wyjście z programu
 
 public:
@@ -0,0 +1,269 @@
+/**
+ * @file batchMode.cpp
+ * @brief Implementacja klasy `BatchMode`.
+ */
+
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "batchMode.hpp"
+#include "csvLoader.hpp"
+#include "fileFollower.hpp"
+#include "queryExecutor.hpp"
+#include "queryServer.hpp"
+#include "threadPool.hpp"
+#include "treeStore.hpp"
+
+/**
+ * @brief Serwer zatrzymywany przez SIGINT i SIGTERM.
+ *
+ * Obsługa sygnału może bezpiecznie odczytać tylko bezblokowy obiekt atomowy.
+ */
+static std::atomic<QueryServer*> activeServer{ nullptr };
+static_assert(ATOMIC_POINTER_LOCK_FREE == 2, "Wskaźnik serwera musi być atomowy bez blokad");
+
+/**
+ * @brief Obsługa SIGINT i SIGTERM: prosi działający serwer o zatrzymanie.
+ */
+static void stopActiveServer(int) {
+    QueryServer* server = activeServer.load();
+    if (server) {
+        server->stop();
+    }
+}
+
+/**
+ * @brief Wypisuje instrukcję użycia na standardowe wyjście błędów.
+ */
+void BatchMode::printUsage(const char* program) {
+    std::cerr << "Użycie: " << program
+              << " (--input <plik.csv> | --snapshot <plik.bin>) [--query <plik> | --listen <gniazdo>|<port>]\n"
+              << "    [--format csv|json] [--threads <n>] [--duplicates skip|replace|flag|keep]\n"
+              << "Zapytania (jedno na wiersz, daty w formacie dd.mm.yyyy hh:mm):\n"
+              << "  range <od> <do>\n"
+              << "  sum <od> <do>\n"
+              << "  avg <od> <do>\n"
+              << "  compare <od1> <do1> <od2> <do2>\n"
+              << "  search <od> <do> <kanał> <wartość> <tolerancja>\n"
+              << "  group <od> <do> 15min|hour|day|week|month|year [kanał,...] [sum,avg,min,max,count]\n"
+              << "Z --listen każda odpowiedź serwera kończy się pustym wierszem.\n";
+}
+
+/**
+ * @brief Odczytuje politykę duplikatów z nazwy.
+ */
+bool BatchMode::parseDuplicatePolicy(const std::string& name, DuplicatePolicy& policy) {
+    static const char* const names[] = {"skip", "replace", "flag", "keep"};
+    for (int i = 0; i < 4; ++i) {
+        if (name == names[i]) {
+            policy = static_cast<DuplicatePolicy>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Uruchamia tryb wsadowy z argumentami wiersza poleceń.
+ */
+int BatchMode::run(int argc, char* argv[]) {
+    std::string inputPath, snapshotPath, queryPath, listen;
+    OutputFormat format = FORMAT_CSV;
+    DuplicatePolicy duplicatePolicy = DUPLICATE_SKIP;
+    size_t threadCount = ThreadPool::defaultThreadCount();
+
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--help" || option == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Brak wartości opcji " << option << std::endl;
+            printUsage(argv[0]);
+            return 2;
+        }
+
+        std::string value = argv[++i];
+        if (option == "--input") {
+            inputPath = value;
+        } else if (option == "--snapshot") {
+            snapshotPath = value;
+        } else if (option == "--query") {
+            queryPath = value;
+        } else if (option == "--listen") {
+            listen = value;
+        } else if (option == "--format" && (value == "csv" || value == "json")) {
+            format = value == "csv" ? FORMAT_CSV : FORMAT_JSON;
+        } else if (option == "--duplicates" && parseDuplicatePolicy(value, duplicatePolicy)) {
+        } else if (option == "--threads" && std::atoi(value.c_str()) > 0) {
+            threadCount = static_cast<size_t>(std::atoi(value.c_str()));
+        } else {
+            std::cerr << "Niepoprawna opcja: " << option << " " << value << std::endl;
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (inputPath.empty() == snapshotPath.empty()) {
+        std::cerr << "Należy podać dokładnie jedną z opcji --input lub --snapshot" << std::endl;
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    if (!listen.empty()) {
+        if (!queryPath.empty()) {
+            std::cerr << "Opcji --query nie można łączyć z --listen" << std::endl;
+            printUsage(argv[0]);
+            return 2;
+        }
+        return serve(listen, inputPath, snapshotPath, format, duplicatePolicy, threadCount);
+    }
+
+    std::ifstream queryFile;
+    if (!queryPath.empty()) {
+        queryFile.open(queryPath);
+        if (!queryFile.is_open()) {
+            std::cerr << "Nie można otworzyć pliku zapytań: " << queryPath << std::endl;
+            return 2;
+        }
+    }
+    std::istream& queries = queryPath.empty() ? std::cin : queryFile;
+
+    TreeData treeData;
+    SnapshotView snapshotView;
+    std::unique_ptr<QueryExecutor> executor;
+    try {
+        if (!inputPath.empty()) {
+            LoadStats stats;
+            treeData.setDuplicatePolicy(duplicatePolicy);
+            if (!CsvLoader::loadFile(inputPath, treeData, stats, threadCount)) {
+                std::cerr << "Nie można otworzyć pliku: " << inputPath << std::endl;
+                return 2;
+            }
+            treeData.buildIndexes();
+            std::cerr << "Wczytano " << stats.loadedLines << " linii, niepoprawnych: " << stats.invalidLines
+                      << ", zduplikowanych: " << stats.duplicateLines << std::endl;
+            executor.reset(new QueryExecutor(treeData, format));
+        } else {
+            if (!snapshotView.open(snapshotPath)) {
+                std::cerr << "Nie można otworzyć pliku: " << snapshotPath << std::endl;
+                return 2;
+            }
+            executor.reset(new QueryExecutor(snapshotView, format));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+
+    std::ios::sync_with_stdio(false);
+    executor->writeHeader(std::cout);
+    size_t failures;
+    try {
+        failures = executor->executeScript(queries, std::cout, std::cerr);
+    } catch (const std::exception& e) {
+        std::cout.flush();
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+    std::cout.flush();
+
+    return failures > 0 ? 1 : 0;
+}
+
+/**
+ * @brief Wczytuje dane i odpowiada na zapytania przez gniazdo do czasu otrzymania sygnału zakończenia.
+ */
+int BatchMode::serve(const std::string& listen, const std::string& inputPath, const std::string& snapshotPath,
+    OutputFormat format, DuplicatePolicy duplicatePolicy, size_t threadCount) {
+    TreeStore store;
+    SnapshotView snapshotView;
+    std::unique_ptr<FileFollower> follower;
+    std::unique_ptr<QueryServer> server;
+    try {
+        if (!inputPath.empty()) {
+            follower.reset(new FileFollower(inputPath));
+            LoadStats stats;
+            bool loaded = store.update([&](TreeData& treeData) {
+                treeData.setDuplicatePolicy(duplicatePolicy);
+                if (!follower->poll(treeData, stats, threadCount)) {
+                    return false;
+                }
+                treeData.buildIndexes();
+                return true;
+            });
+            if (!loaded) {
+                std::cerr << "Nie można otworzyć pliku: " << inputPath << std::endl;
+                return 2;
+            }
+            std::cerr << "Wczytano " << stats.loadedLines << " linii, niepoprawnych: " << stats.invalidLines
+                      << ", zduplikowanych: " << stats.duplicateLines << std::endl;
+            server.reset(new QueryServer(store, format, threadCount));
+        } else {
+            if (!snapshotView.open(snapshotPath)) {
+                std::cerr << "Nie można otworzyć pliku: " << snapshotPath << std::endl;
+                return 2;
+            }
+            server.reset(new QueryServer(snapshotView, format, threadCount));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+
+    bool tcp = listen.find_first_not_of("0123456789") == std::string::npos && listen.size() <= 5
+        && std::atoi(listen.c_str()) <= 65535;
+    bool listening = tcp ? server->listenTcp(static_cast<uint16_t>(std::atoi(listen.c_str())))
+                         : server->listenUnix(listen);
+    if (!listening) {
+        std::cerr << "Nie można nasłuchiwać na " << listen << std::endl;
+        return 2;
+    }
+    std::cerr << "Serwer zapytań nasłuchuje na "
+              << (tcp ? "127.0.0.1:" + std::to_string(server->getPort()) : listen) << std::endl;
+
+    activeServer = server.get();
+    std::signal(SIGINT, stopActiveServer);
+    std::signal(SIGTERM, stopActiveServer);
+
+    // Wiersze dopisywane do pliku CSV wczytywane są do nowych wersji drzewa w czasie obsługi zapytań
+    std::thread ingest;
+    if (follower) {
+        ingest = std::thread([&]() {
+            while (!server->isStopping()) {
+                LoadStats stats;
+                store.update([&](TreeData& treeData) {
+                    if (!follower->poll(treeData, stats, threadCount) || stats.loadedLines == 0) {
+                        return false;
+                    }
+                    treeData.buildIndexes();
+                    return true;
+                });
+                if (stats.loadedLines > 0 || stats.invalidLines > 0) {
+                    std::cerr << "Wczytano " << stats.loadedLines << " nowych linii, niepoprawnych: "
+                              << stats.invalidLines << std::endl;
+                }
+                follower->waitForChange(500);
+            }
+        });
+    }
+
+    server->run();
+    if (ingest.joinable()) {
+        ingest.join();
+    }
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    activeServer = nullptr;
+    std::cerr << "Serwer zapytań zatrzymany" << std::endl;
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file batchMode.hpp
+ * @brief Deklaracja klasy `BatchMode` obsługującej nieinteraktywny tryb wsadowy programu.
+ *
+ * ## Użycie:
+ * @code
+ * projekt6 (--input <plik.csv> | --snapshot <plik.bin>) [--query <plik> | --listen <gniazdo>|<port>]
+ *          [--format csv|json] [--threads <n>] [--duplicates skip|replace|flag|keep]
+ * @endcode
+ *
+ * Zapytania (jedno na wiersz):
+ * @code
+ * range <od> <do>
+ * sum <od> <do>
+ * avg <od> <do>
+ * compare <od1> <do1> <od2> <do2>
+ * search <od> <do> <kanał> <wartość> <tolerancja>
+ * group <od> <do> 15min|hour|day|week|month|year [kanał,...] [sum,avg,min,max,count]
+ * @endcode
+ *
+ * Dane wczytywane są raz, a następnie wykonywane są kolejno wszystkie zapytania z pliku
+ * `--query` (lub ze standardowego wejścia). Składnię zapytań i format wyników opisuje `QueryExecutor`.
+ * Migawka podana przez `--snapshot` nie jest wczytywana do pamięci, tylko odwzorowywana (`SnapshotView`).
+ * Opcja `--duplicates` wybiera `DuplicatePolicy` dla wierszy CSV o powtórzonej dacie (domyślnie `skip`).
+ *
+ * Z opcją `--listen` program działa jako serwer zapytań (`QueryServer`) na gnieździe Unix o podanej
+ * ścieżce lub, jeśli podano liczbę, na porcie TCP adresu 127.0.0.1, do czasu otrzymania SIGINT lub SIGTERM.
+ * Zapytania wykonuje `--threads` wątków. Plik `--input` jest w tym czasie śledzony i dopisywane
+ * wiersze są wczytywane bez przerywania odpowiedzi (`TreeStore`).
+ */
+
+#ifndef BATCHMODE_HPP
+#define BATCHMODE_HPP
+
+#include <string>
+
+#include "queryExecutor.hpp"
+#include "treeData.hpp"
+
+/**
+ * @class BatchMode
+ * @brief Klasa narzędziowa uruchamiająca tryb wsadowy.
+ */
+class BatchMode {
+public:
+    BatchMode() = delete;
+    BatchMode(const BatchMode&) = delete;
+    BatchMode& operator=(const BatchMode&) = delete;
+
+    /**
+     * @brief Uruchamia tryb wsadowy z argumentami wiersza poleceń.
+     * @param argc Liczba argumentów.
+     * @param argv Argumenty.
+     * @return 0 - wszystkie zapytania wykonane, 1 - część zapytań była błędna,
+     *         2 - niepoprawne argumenty lub błąd wczytywania danych.
+     */
+    static int run(int argc, char* argv[]);
+
+private:
+    /**
+     * @brief Wypisuje instrukcję użycia na standardowe wyjście błędów.
+     */
+    static void printUsage(const char* program);
+
+    /**
+     * @brief Wczytuje dane i odpowiada na zapytania przez gniazdo do czasu otrzymania sygnału zakończenia.
+     * @param listen Ścieżka gniazda Unix lub numer portu TCP.
+     * @param inputPath Plik CSV (śledzony) lub pusty.
+     * @param snapshotPath Plik migawki lub pusty.
+     * @param format Format wyników.
+     * @param duplicatePolicy Polityka duplikatów dla wierszy CSV.
+     * @param threadCount Liczba wątków wczytywania i wykonywania zapytań.
+     * @return 0 - serwer zakończony sygnałem, 2 - błąd wczytywania danych lub gniazda.
+     */
+    static int serve(const std::string& listen, const std::string& inputPath, const std::string& snapshotPath,
+        OutputFormat format, DuplicatePolicy duplicatePolicy, size_t threadCount);
+
+    /**
+     * @brief Odczytuje politykę duplikatów z nazwy (`skip`, `replace`, `flag`, `keep`).
+     * @return `false`, jeśli nazwa jest nieznana.
+     */
+    static bool parseDuplicatePolicy(const std::string& name, DuplicatePolicy& policy);
+};
+
+#endif
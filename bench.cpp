@@ -0,0 +1,449 @@
+/**
+ * @file bench.cpp
+ * @brief Testy wydajności (Google Benchmark) na syntetycznych danych z `DataGenerator`.
+ *
+ * ## Budowanie i uruchomienie:
+ * @code
+ * g++ -std=c++17 -O2 -pthread bench.cpp $(ls *.cpp | grep -v -e main.cpp -e test.cpp -e bench.cpp) -lbenchmark -o bench
+ * ./bench [--max_rows=<n>] [--benchmark_filter=<wyrażenie>] [inne opcje Google Benchmark]
+ * ./bench --generate=<plik.csv|plik.bin> [--rows=<n>] [--interval=<minuty>] [--compressed]
+ * @endcode
+ *
+ * Każdy test uruchamiany jest dla 10 tys., 100 tys., 1 mln, 10 mln i 50 mln rekordów
+ * (do limitu `--max_rows`, domyślnie 10 mln) w rozdzielczości 15- i 1-minutowej.
+ * Zbiory danych są generowane raz dla każdego rozmiaru i współdzielone przez kolejne testy.
+ *
+ * Mierzone są:
+ * - `LoadCsv`, `LoadCsvParallel` - wczytywanie CSV z pamięci (rekordy/s i MB/s),
+ * - `AddData`, `AddRecord` - dodawanie rekordów do drzewa (rekordy/s),
+ * - `Range` - `getDataBetweenDates` dla przedziału godziny, dnia, miesiąca i roku (duże przedziały równolegle),
+ * - `Sums`, `Averages`, `Compare` - obliczenia na przedziale dnia, miesiąca i roku,
+ * - `Search` - wyszukiwanie z tolerancją w roku danych,
+ * - `Rollup` - seria godzinowa, dobowa i miesięczna z roku danych,
+ * - `Serialize`, `Deserialize` - zapis i odczyt migawki (surowej i skompresowanej, MB/s).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "csvLoader.hpp"
+#include "dataGenerator.hpp"
+#include "dateTime.hpp"
+#include "snapshot.hpp"
+#include "threadPool.hpp"
+#include "treeData.hpp"
+
+/** Liczby rekordów, dla których uruchamiane są testy. */
+static const size_t ROW_COUNTS[] = {10000, 100000, 1000000, 10000000, 50000000};
+
+/** Rozdzielczości danych w minutach. */
+static const int INTERVALS[] = {15, 1};
+
+/**
+ * @struct Span
+ * @brief Długość przedziału zapytania.
+ */
+struct Span {
+    const char* name; /**< Nazwa w nazwie testu. */
+    int64_t minutes; /**< Długość w minutach. */
+};
+
+/** Długości przedziałów zapytań. */
+static const Span SPANS[] = {{"hour", 60}, {"day", 24 * 60}, {"month", 30 * 24 * 60}, {"year", 365 * 24 * 60}};
+
+/**
+ * @brief Zwraca parametry generatora dla zbioru o podanym rozmiarze i rozdzielczości.
+ */
+static GeneratorOptions datasetOptions(size_t rows, int interval) {
+    GeneratorOptions options;
+    options.recordCount = rows;
+    options.interval = interval;
+    return options;
+}
+
+/**
+ * @brief Zwraca drzewo z danymi testowymi (ostatnio użyty zbiór jest przechowywany).
+ */
+static const TreeData& dataset(size_t rows, int interval) {
+    static std::unique_ptr<TreeData> treeData;
+    static size_t cachedRows = 0;
+    static int cachedInterval = 0;
+
+    if (!treeData || cachedRows != rows || cachedInterval != interval) {
+        treeData.reset();
+        treeData.reset(new TreeData());
+        DataGenerator generator(datasetOptions(rows, interval));
+        generator.fill(*treeData);
+        treeData->buildIndexes();
+        cachedRows = rows;
+        cachedInterval = interval;
+    }
+    return *treeData;
+}
+
+/**
+ * @brief Zwraca dane testowe w postaci CSV (ostatnio użyty zbiór jest przechowywany).
+ */
+static const std::string& csvDataset(size_t rows, int interval) {
+    static std::string csv;
+    static size_t cachedRows = 0;
+    static int cachedInterval = 0;
+
+    if (cachedRows != rows || cachedInterval != interval) {
+        std::string().swap(csv);
+        std::ostringstream out;
+        DataGenerator generator(datasetOptions(rows, interval));
+        generator.writeCsv(out);
+        csv = out.str();
+        cachedRows = rows;
+        cachedInterval = interval;
+    }
+    return csv;
+}
+
+/**
+ * @brief Zwraca przedział o podanej długości położony w środku zbioru danych.
+ */
+static void middleRange(size_t rows, int interval, int64_t minutes, std::string& startDate, std::string& endDate) {
+    GeneratorOptions options = datasetOptions(rows, interval);
+    int64_t middle = options.start + static_cast<int64_t>(rows / 2) * interval;
+    startDate = formatTimestamp(middle - minutes / 2);
+    endDate = formatTimestamp(middle - minutes / 2 + minutes - 1);
+}
+
+/**
+ * @brief Wczytywanie CSV z pamięci (sekwencyjne lub równoległe).
+ */
+static void benchLoadCsv(benchmark::State& state, size_t rows, int interval, size_t threadCount) {
+    const std::string& csv = csvDataset(rows, interval);
+    for (auto _ : state) {
+        TreeData treeData;
+        LoadStats stats = threadCount > 1
+            ? CsvLoader::loadBufferParallel(csv.data(), csv.size(), treeData, threadCount)
+            : CsvLoader::loadBuffer(csv.data(), csv.size(), treeData);
+        benchmark::DoNotOptimize(stats.loadedLines);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * csv.size()));
+}
+
+/**
+ * @brief Dodawanie rekordów `LineData` do pustego drzewa.
+ */
+static void benchAddData(benchmark::State& state, size_t rows, int interval) {
+    std::vector<LineData> records;
+    records.reserve(rows);
+    DataGenerator generator(datasetOptions(rows, interval));
+    int64_t timestamp;
+    float values[CHANNEL_COUNT];
+    while (generator.next(timestamp, values)) {
+        records.emplace_back(timestamp, values[AUTOKONSUMPCJA], values[EKSPORT], values[IMPORT], values[POBOR], values[PRODUKCJA]);
+    }
+
+    for (auto _ : state) {
+        TreeData treeData;
+        for (const LineData& record : records) {
+            treeData.addData(record);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+}
+
+/**
+ * @brief Dodawanie rekordów kolumnowych przez `addRecord`.
+ */
+static void benchAddRecord(benchmark::State& state, size_t rows, int interval) {
+    std::vector<int64_t> timestamps;
+    std::vector<float> values;
+    timestamps.reserve(rows);
+    values.reserve(rows * CHANNEL_COUNT);
+    DataGenerator generator(datasetOptions(rows, interval));
+    int64_t timestamp;
+    float record[CHANNEL_COUNT];
+    while (generator.next(timestamp, record)) {
+        timestamps.push_back(timestamp);
+        values.insert(values.end(), record, record + CHANNEL_COUNT);
+    }
+
+    for (auto _ : state) {
+        TreeData treeData;
+        for (size_t i = 0; i < timestamps.size(); ++i) {
+            treeData.addRecord(timestamps[i], &values[i * CHANNEL_COUNT]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+}
+
+/**
+ * @brief Pobieranie rekordów z przedziału przez `getDataBetweenDates`.
+ */
+static void benchRange(benchmark::State& state, size_t rows, int interval, int64_t minutes) {
+    const TreeData& treeData = dataset(rows, interval);
+    std::string startDate, endDate;
+    middleRange(rows, interval, minutes, startDate, endDate);
+
+    size_t found = 0;
+    for (auto _ : state) {
+        std::vector<LineData> result = treeData.getDataBetweenDates(startDate, endDate);
+        found = result.size();
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.counters["records"] = static_cast<double>(found);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * found));
+}
+
+/**
+ * @brief Obliczanie sum kanałów w przedziale.
+ */
+static void benchSums(benchmark::State& state, size_t rows, int interval, int64_t minutes) {
+    const TreeData& treeData = dataset(rows, interval);
+    std::string startDate, endDate;
+    middleRange(rows, interval, minutes, startDate, endDate);
+
+    float values[CHANNEL_COUNT];
+    for (auto _ : state) {
+        treeData.calculateSumsBetweenDates(startDate, endDate, values[0], values[1], values[2], values[3], values[4]);
+        benchmark::DoNotOptimize(values);
+    }
+}
+
+/**
+ * @brief Obliczanie średnich kanałów w przedziale.
+ */
+static void benchAverages(benchmark::State& state, size_t rows, int interval, int64_t minutes) {
+    const TreeData& treeData = dataset(rows, interval);
+    std::string startDate, endDate;
+    middleRange(rows, interval, minutes, startDate, endDate);
+
+    float values[CHANNEL_COUNT];
+    for (auto _ : state) {
+        treeData.calculateAveragesBetweenDates(startDate, endDate, values[0], values[1], values[2], values[3], values[4]);
+        benchmark::DoNotOptimize(values);
+    }
+}
+
+/**
+ * @brief Porównanie sum w dwóch przedziałach.
+ */
+static void benchCompare(benchmark::State& state, size_t rows, int interval, int64_t minutes) {
+    const TreeData& treeData = dataset(rows, interval);
+    std::string startDate1, endDate1, startDate2, endDate2;
+    middleRange(rows, interval, minutes, startDate2, endDate2);
+    middleRange(rows / 2, interval, minutes, startDate1, endDate1);
+
+    float values[CHANNEL_COUNT];
+    for (auto _ : state) {
+        treeData.compareDataBetweenDates(startDate1, endDate1, startDate2, endDate2,
+            values[0], values[1], values[2], values[3], values[4]);
+        benchmark::DoNotOptimize(values);
+    }
+}
+
+/**
+ * @brief Wyszukiwanie z tolerancją w roku danych.
+ */
+static void benchSearch(benchmark::State& state, size_t rows, int interval) {
+    const TreeData& treeData = dataset(rows, interval);
+    std::string startDate, endDate;
+    middleRange(rows, interval, 365 * 24 * 60, startDate, endDate);
+
+    // Pobór w okolicy szczytu wieczornego - rzadkie, ale nie puste wyniki
+    float value = 3.0f * interval / 60.0f;
+    float tolerance = 0.01f * interval / 60.0f;
+    size_t found = 0;
+    for (auto _ : state) {
+        found = 0;
+        treeData.forEachWithTolerance(startDate, endDate, value, tolerance, POBOR, [&found](const RecordView&) { ++found; });
+        benchmark::DoNotOptimize(found);
+    }
+    state.counters["records"] = static_cast<double>(found);
+}
+
+/**
+ * @brief Seria zagregowana z roku danych w zadanej rozdzielczości.
+ */
+static void benchRollup(benchmark::State& state, size_t rows, int interval, Resolution resolution) {
+    const TreeData& treeData = dataset(rows, interval);
+    std::string startDate, endDate;
+    middleRange(rows, interval, 365 * 24 * 60, startDate, endDate);
+
+    size_t points = 0;
+    for (auto _ : state) {
+        std::vector<RollupPoint> series = treeData.rollupBetweenDates(startDate, endDate, resolution);
+        points = series.size();
+        benchmark::DoNotOptimize(series.data());
+    }
+    state.counters["points"] = static_cast<double>(points);
+}
+
+/**
+ * @brief Zapis migawki do pamięci.
+ */
+static void benchSerialize(benchmark::State& state, size_t rows, int interval, bool compressed) {
+    const TreeData& treeData = dataset(rows, interval);
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::ostringstream out;
+        Snapshot::write(treeData, out, compressed);
+        bytes = static_cast<size_t>(out.tellp());
+    }
+    state.counters["file_MB"] = bytes / 1e6;
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+
+/**
+ * @brief Odczyt migawki z pamięci do pustego drzewa.
+ */
+static void benchDeserialize(benchmark::State& state, size_t rows, int interval, bool compressed) {
+    std::ostringstream out;
+    Snapshot::write(dataset(rows, interval), out, compressed);
+    const std::string snapshot = out.str();
+
+    for (auto _ : state) {
+        std::istringstream in(snapshot);
+        TreeData treeData;
+        benchmark::DoNotOptimize(Snapshot::read(in, treeData));
+    }
+    state.counters["file_MB"] = snapshot.size() / 1e6;
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * snapshot.size()));
+}
+
+/**
+ * @brief Rejestruje wszystkie testy dla zbiorów nie większych niż `maxRows`.
+ *
+ * Testy rejestrowane są kolejno dla każdego zbioru, aby zbiór był generowany tylko raz.
+ */
+static void registerBenchmarks(size_t maxRows) {
+    size_t threadCount = ThreadPool::defaultThreadCount();
+    for (size_t rows : ROW_COUNTS) {
+        if (rows > maxRows) {
+            continue;
+        }
+        for (int interval : INTERVALS) {
+            std::string suffix = "/rows:" + std::to_string(rows) + "/interval:" + std::to_string(interval);
+
+            benchmark::RegisterBenchmark(("LoadCsv" + suffix).c_str(), benchLoadCsv, rows, interval, 1)
+                ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("LoadCsvParallel" + suffix).c_str(), benchLoadCsv, rows, interval, threadCount)
+                ->Unit(benchmark::kMillisecond)->UseRealTime();
+            benchmark::RegisterBenchmark(("AddData" + suffix).c_str(), benchAddData, rows, interval)
+                ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("AddRecord" + suffix).c_str(), benchAddRecord, rows, interval)
+                ->Unit(benchmark::kMillisecond);
+
+            for (const Span& span : SPANS) {
+                std::string name = suffix + "/span:" + span.name;
+                benchmark::RegisterBenchmark(("Range" + name).c_str(), benchRange, rows, interval, span.minutes)
+                    ->Unit(benchmark::kMicrosecond);
+                if (span.minutes > 60) {
+                    benchmark::RegisterBenchmark(("Sums" + name).c_str(), benchSums, rows, interval, span.minutes)
+                        ->Unit(benchmark::kMicrosecond);
+                    benchmark::RegisterBenchmark(("Averages" + name).c_str(), benchAverages, rows, interval, span.minutes)
+                        ->Unit(benchmark::kMicrosecond);
+                    benchmark::RegisterBenchmark(("Compare" + name).c_str(), benchCompare, rows, interval, span.minutes)
+                        ->Unit(benchmark::kMicrosecond);
+                }
+            }
+
+            benchmark::RegisterBenchmark(("Search" + suffix).c_str(), benchSearch, rows, interval)
+                ->Unit(benchmark::kMicrosecond);
+            benchmark::RegisterBenchmark(("Rollup" + suffix + "/hour").c_str(), benchRollup, rows, interval, RESOLUTION_HOUR)
+                ->Unit(benchmark::kMicrosecond);
+            benchmark::RegisterBenchmark(("Rollup" + suffix + "/day").c_str(), benchRollup, rows, interval, RESOLUTION_DAY)
+                ->Unit(benchmark::kMicrosecond);
+            benchmark::RegisterBenchmark(("Rollup" + suffix + "/month").c_str(), benchRollup, rows, interval, RESOLUTION_MONTH)
+                ->Unit(benchmark::kMicrosecond);
+            benchmark::RegisterBenchmark(("Serialize" + suffix + "/raw").c_str(), benchSerialize, rows, interval, false)
+                ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("Serialize" + suffix + "/compressed").c_str(), benchSerialize, rows, interval, true)
+                ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("Deserialize" + suffix + "/raw").c_str(), benchDeserialize, rows, interval, false)
+                ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("Deserialize" + suffix + "/compressed").c_str(), benchDeserialize, rows, interval, true)
+                ->Unit(benchmark::kMillisecond);
+        }
+    }
+}
+
+/**
+ * @brief Zapisuje wygenerowany zbiór danych do pliku (CSV lub migawka, zależnie od rozszerzenia).
+ * @return Kod wyjścia programu.
+ */
+static int generateFile(const std::string& path, const GeneratorOptions& options, bool compressed) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Nie można otworzyć pliku: " << path << std::endl;
+        return 1;
+    }
+
+    DataGenerator generator(options);
+    if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0) {
+        generator.writeCsv(out);
+    } else {
+        generator.writeSnapshot(out, compressed);
+    }
+    std::cerr << "Zapisano " << generator.getGeneratedCount() << " rekordów i "
+              << generator.getMalformedCount() << " błędnych wierszy do " << path << std::endl;
+    return out.good() ? 0 : 1;
+}
+
+/**
+ * @brief Zwraca wartość opcji `--name=value`, jeśli argument ją zawiera.
+ */
+static const char* optionValue(const char* argument, const char* name) {
+    size_t length = std::strlen(name);
+    if (std::strncmp(argument, name, length) == 0 && argument[length] == '=') {
+        return argument + length + 1;
+    }
+    return nullptr;
+}
+
+int main(int argc, char* argv[]) {
+    size_t maxRows = 10000000;
+    std::string generatePath;
+    GeneratorOptions options;
+    bool compressed = false;
+
+    // Własne opcje są usuwane z listy przed przekazaniem jej do Google Benchmark
+    int remaining = 1;
+    for (int i = 1; i < argc; ++i) {
+        const char* value;
+        if ((value = optionValue(argv[i], "--max_rows"))) {
+            maxRows = std::strtoull(value, nullptr, 10);
+        } else if ((value = optionValue(argv[i], "--generate"))) {
+            generatePath = value;
+        } else if ((value = optionValue(argv[i], "--rows"))) {
+            options.recordCount = std::strtoull(value, nullptr, 10);
+        } else if ((value = optionValue(argv[i], "--interval"))) {
+            options.interval = std::atoi(value);
+        } else if (std::strcmp(argv[i], "--compressed") == 0) {
+            compressed = true;
+        } else {
+            argv[remaining++] = argv[i];
+        }
+    }
+    argc = remaining;
+
+    if (!generatePath.empty()) {
+        return generateFile(generatePath, options, compressed);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    registerBenchmarks(maxRows);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
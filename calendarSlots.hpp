@@ -0,0 +1,165 @@
+/**
+ * @file calendarSlots.hpp
+ * @brief Deklaracja szablonu `CalendarSlots` - tablicy węzłów indeksowanej numerem miesiąca, dnia lub kwartału.
+ */
+
+#ifndef CALENDARSLOTS_HPP
+#define CALENDARSLOTS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @class CalendarSlots
+ * @brief Tablica o stałym rozmiarze z mapą bitową zajętych pozycji.
+ *
+ * Zastępuje `std::map` dla małych, gęstych dziedzin kalendarzowych (12 miesięcy, 31 dni, 4 kwartały):
+ * węzeł o kluczu `key` leży pod indeksem `key - First`, więc wyszukiwanie i wstawianie sprowadzają
+ * się do arytmetyki. Iteracja przechodzi wyłącznie po zajętych pozycjach, w rosnącej kolejności kluczy,
+ * zwracając referencje do węzłów (klucz przechowuje sam węzeł).
+ *
+ * @tparam Node Typ węzła.
+ * @tparam Size Liczba pozycji (najwyżej 32).
+ * @tparam First Klucz pierwszej pozycji.
+ */
+template <typename Node, int Size, int First>
+class CalendarSlots {
+    static_assert(Size > 0 && Size <= 32, "Mapa zajętości mieści się w 32 bitach");
+
+public:
+    /**
+     * @class Iterator
+     * @brief Iterator po zajętych pozycjach, przechowujący mapę jeszcze nieodwiedzonych bitów.
+     */
+    template <typename Slots, typename Value>
+    class Iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Node value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Value* pointer;
+        typedef Value& reference;
+
+        Iterator(Slots* slots, uint32_t remaining) : slots(slots), remaining(remaining) {}
+
+        Value& operator*() const { return slots->slots[lowestBit(remaining)]; }
+        Value* operator->() const { return &**this; }
+
+        Iterator& operator++() {
+            remaining &= remaining - 1;
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const { return remaining == other.remaining; }
+        bool operator!=(const Iterator& other) const { return remaining != other.remaining; }
+
+    private:
+        Slots* slots;
+        uint32_t remaining;
+    };
+
+    /**
+     * @class Range
+     * @brief Zakres zajętych pozycji do użycia w pętli `for`.
+     */
+    template <typename Slots, typename Value>
+    class Range {
+    public:
+        Range(Slots* slots, uint32_t mask) : slots(slots), mask(mask) {}
+
+        Iterator<Slots, Value> begin() const { return Iterator<Slots, Value>(slots, mask); }
+        Iterator<Slots, Value> end() const { return Iterator<Slots, Value>(slots, 0); }
+
+    private:
+        Slots* slots;
+        uint32_t mask;
+    };
+
+    typedef Iterator<CalendarSlots, Node> iterator;
+    typedef Iterator<const CalendarSlots, const Node> const_iterator;
+
+    /**
+     * @brief Zwraca węzeł o podanym kluczu, oznaczając pozycję jako zajętą.
+     * @param key Klucz z przedziału [First, First + Size).
+     */
+    Node& operator[](int key) {
+        occupied |= uint32_t(1) << (key - First);
+        return slots[key - First];
+    }
+
+    /**
+     * @brief Zwraca wskaźnik na węzeł o podanym kluczu lub `nullptr`, jeśli pozycja jest wolna.
+     */
+    Node* find(int key) { return contains(key) ? &slots[key - First] : nullptr; }
+    const Node* find(int key) const { return contains(key) ? &slots[key - First] : nullptr; }
+
+    /**
+     * @brief Sprawdza, czy pozycja o podanym kluczu jest zajęta.
+     */
+    bool contains(int key) const {
+        return key >= First && key < First + Size && (occupied >> (key - First)) & 1;
+    }
+
+    /**
+     * @brief Zwraca liczbę zajętych pozycji.
+     */
+    size_t size() const {
+        size_t count = 0;
+        for (uint32_t mask = occupied; mask != 0; mask &= mask - 1) {
+            ++count;
+        }
+        return count;
+    }
+
+    bool empty() const { return occupied == 0; }
+
+    iterator begin() { return iterator(this, occupied); }
+    iterator end() { return iterator(this, 0); }
+    const_iterator begin() const { return const_iterator(this, occupied); }
+    const_iterator end() const { return const_iterator(this, 0); }
+
+    /**
+     * @brief Zwraca zajęte pozycje o kluczach z przedziału [firstKey, lastKey].
+     */
+    Range<const CalendarSlots, const Node> range(int firstKey, int lastKey) const {
+        return Range<const CalendarSlots, const Node>(this, occupied & rangeMask(firstKey, lastKey));
+    }
+
+private:
+    /**
+     * @brief Zwraca maskę pozycji o kluczach z przedziału [firstKey, lastKey].
+     */
+    static uint32_t rangeMask(int firstKey, int lastKey) {
+        int low = firstKey - First < 0 ? 0 : firstKey - First;
+        int high = lastKey - First >= Size ? Size - 1 : lastKey - First;
+        if (low > high) {
+            return 0;
+        }
+        uint32_t upTo = high == 31 ? ~uint32_t(0) : (uint32_t(1) << (high + 1)) - 1;
+        return upTo & ~((uint32_t(1) << low) - 1);
+    }
+
+    /**
+     * @brief Zwraca numer najmłodszego ustawionego bitu.
+     */
+    static int lowestBit(uint32_t mask) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    std::array<Node, Size> slots; /**< Węzły indeksowane `klucz - First`. */
+    uint32_t occupied = 0; /**< Mapa bitowa zajętych pozycji. */
+};
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @file csvLoader.cpp
+ * @brief Implementacja klasy `CsvLoader`.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <vector>
+
+#include "csvLoader.hpp"
+#include "lineValidation.hpp"
+#include "logger.hpp"
+#include "mappedFile.hpp"
+#include "threadPool.hpp"
+
+/** Minimalny rozmiar fragmentu przy wczytywaniu równoległym. */
+static const size_t MIN_CHUNK_SIZE = 1 << 20;
+
+/**
+ * @brief Wczytuje wszystkie wiersze z bufora do drzewa.
+ * @param data Początek bufora.
+ * @param size Rozmiar bufora.
+ * @param treeData Drzewo docelowe.
+ * @return Statystyki wczytania.
+ */
+LoadStats CsvLoader::loadBuffer(const char* data, size_t size, TreeData& treeData) {
+    LoadStats stats;
+    const char* position = data;
+    const char* bufferEnd = data + size;
+    size_t duplicatesBefore = treeData.getDuplicateCount();
+
+    while (position < bufferEnd) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(position, '\n', bufferEnd - position));
+        if (lineEnd == nullptr) {
+            lineEnd = bufferEnd;
+        }
+
+        ParsedLine parsed;
+        LineError error = scanLine(position, lineEnd, parsed);
+        if (error == LINE_OK) {
+            treeData.addRecord(parsed.timestamp, parsed.values);
+            ++stats.loadedLines;
+        } else {
+            loggerError.log(std::string(lineErrorMessage(error)) + ": " + std::string(position, lineEnd));
+            ++stats.invalidLines;
+        }
+
+        position = lineEnd + 1;
+    }
+
+    stats.duplicateLines = treeData.getDuplicateCount() - duplicatesBefore;
+    return stats;
+}
+
+/**
+ * @brief Wczytuje bufor równolegle na puli wątków.
+ * @param data Początek bufora.
+ * @param size Rozmiar bufora.
+ * @param treeData Drzewo docelowe.
+ * @param threadCount Liczba wątków roboczych.
+ * @return Statystyki wczytania.
+ */
+LoadStats CsvLoader::loadBufferParallel(const char* data, size_t size, TreeData& treeData, size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = ThreadPool::defaultThreadCount();
+    }
+    if (threadCount <= 1 || size < 2 * MIN_CHUNK_SIZE) {
+        return loadBuffer(data, size, treeData);
+    }
+
+    struct ChunkResult {
+        TreeData tree;
+        LoadStats stats;
+    };
+
+    size_t chunkSize = std::max(MIN_CHUNK_SIZE, size / (threadCount * 4));
+    const char* bufferEnd = data + size;
+    DuplicatePolicy policy = treeData.getDuplicatePolicy();
+    size_t duplicatesBefore = treeData.getDuplicateCount();
+    std::vector<std::future<ChunkResult>> chunks;
+    ThreadPool pool(threadCount);
+
+    const char* chunkBegin = data;
+    while (chunkBegin < bufferEnd) {
+        const char* chunkEnd = chunkBegin + std::min(chunkSize, static_cast<size_t>(bufferEnd - chunkBegin));
+        if (chunkEnd < bufferEnd) {
+            const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', bufferEnd - chunkEnd));
+            chunkEnd = newline != nullptr ? newline + 1 : bufferEnd;
+        }
+
+        chunks.push_back(pool.submit([chunkBegin, chunkEnd, policy]() {
+            ChunkResult result;
+            result.tree.setDuplicatePolicy(policy);
+            result.stats = loadBuffer(chunkBegin, chunkEnd - chunkBegin, result.tree);
+            return result;
+        }));
+        chunkBegin = chunkEnd;
+    }
+
+    LoadStats stats;
+    for (auto& chunk : chunks) {
+        ChunkResult result = chunk.get();
+        treeData.merge(std::move(result.tree));
+        stats.loadedLines += result.stats.loadedLines;
+        stats.invalidLines += result.stats.invalidLines;
+    }
+
+    // Duplikaty wewnątrz fragmentów i między nimi zliczane są przez drzewo docelowe przy scalaniu
+    stats.duplicateLines = treeData.getDuplicateCount() - duplicatesBefore;
+    return stats;
+}
+
+/**
+ * @brief Odwzorowuje plik w pamięci i wczytuje go do drzewa.
+ * @param path Ścieżka do pliku CSV.
+ * @param treeData Drzewo docelowe.
+ * @param stats Statystyki wczytania (wyjście).
+ * @param threadCount Liczba wątków parsujących.
+ * @return `false`, jeśli pliku nie udało się otworzyć.
+ */
+bool CsvLoader::loadFile(const std::string& path, TreeData& treeData, LoadStats& stats, size_t threadCount) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+
+    file.adviseSequential();
+    stats = loadBufferParallel(file.data(), file.size(), treeData, threadCount);
+    return true;
+}
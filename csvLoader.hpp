@@ -0,0 +1,77 @@
+/**
+ * @file csvLoader.hpp
+ * @brief Deklaracja klasy `CsvLoader` wczytującej eksport CSV licznika bezpośrednio z pliku odwzorowanego w pamięci.
+ */
+
+#ifndef CSVLOADER_HPP
+#define CSVLOADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "treeData.hpp"
+
+/**
+ * @struct LoadStats
+ * @brief Statystyki pojedynczego wczytania danych.
+ */
+struct LoadStats {
+    size_t loadedLines = 0; /**< Liczba poprawnie wczytanych linii. */
+    size_t invalidLines = 0; /**< Liczba odrzuconych linii. */
+    size_t duplicateLines = 0; /**< Liczba poprawnych linii z istniejącym już znacznikiem czasu (zob. `DuplicatePolicy`). */
+};
+
+/**
+ * @class CsvLoader
+ * @brief Klasa narzędziowa wczytująca pliki CSV do `TreeData` bez kopiowania linii.
+ *
+ * Plik jest odwzorowywany w pamięci, a wiersze są walidowane i parsowane bezpośrednio
+ * z odwzorowanych bajtów przez `scanLine`.
+ * Poprawny wiersz nie powoduje żadnej alokacji na stercie poza dopisaniem do kolumn drzewa.
+ * Odrzucone wiersze są zapisywane do `loggerError` wraz z opisem kodu `LineError`.
+ * Duplikaty znaczników czasu obsługiwane są zgodnie z polityką duplikatów drzewa docelowego.
+ */
+class CsvLoader {
+public:
+    CsvLoader() = delete;
+    CsvLoader(const CsvLoader&) = delete;
+    CsvLoader& operator=(const CsvLoader&) = delete;
+
+    /**
+     * @brief Wczytuje wszystkie wiersze z bufora do drzewa.
+     * @param data Początek bufora z zawartością CSV.
+     * @param size Rozmiar bufora w bajtach.
+     * @param treeData Drzewo, do którego dodawane są rekordy.
+     * @return Statystyki wczytania.
+     */
+    static LoadStats loadBuffer(const char* data, size_t size, TreeData& treeData);
+
+    /**
+     * @brief Wczytuje bufor równolegle na puli wątków.
+     *
+     * Bufor jest dzielony na fragmenty na granicach linii. Każdy fragment jest parsowany przez
+     * wątek roboczy do własnego, częściowego drzewa, a wątek wywołujący scala gotowe drzewa
+     * w kolejności fragmentów, podczas gdy kolejne fragmenty są jeszcze parsowane. Wynikowe
+     * rekordy i liczniki są takie same jak przy `loadBuffer`.
+     *
+     * @param data Początek bufora z zawartością CSV.
+     * @param size Rozmiar bufora w bajtach.
+     * @param treeData Drzewo, do którego dodawane są rekordy.
+     * @param threadCount Liczba wątków roboczych (0 oznacza liczbę rdzeni).
+     * @return Statystyki wczytania.
+     */
+    static LoadStats loadBufferParallel(const char* data, size_t size, TreeData& treeData, size_t threadCount);
+
+    /**
+     * @brief Odwzorowuje plik w pamięci i wczytuje go do drzewa.
+     * @param path Ścieżka do pliku CSV.
+     * @param treeData Drzewo, do którego dodawane są rekordy.
+     * @param stats Statystyki wczytania (wyjście).
+     * @param threadCount Liczba wątków parsujących (1 oznacza wczytanie sekwencyjne, 0 liczbę rdzeni).
+     * @return `false`, jeśli pliku nie udało się otworzyć.
+     */
+    static bool loadFile(const std::string& path, TreeData& treeData, LoadStats& stats, size_t threadCount = 1);
+};
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ * @file dataGenerator.cpp
+ * @brief Implementacja klasy `DataGenerator`.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "dataGenerator.hpp"
+#include "dateTime.hpp"
+#include "snapshot.hpp"
+
+/** Liczba minut w dobie. */
+static const int64_t MINUTES_PER_DAY = 24 * 60;
+
+/** Nagłówek pliku CSV w formacie eksportu z licznika. */
+static const char CSV_HEADER[] = "\"Time\",\"Autokonsumpcja\",\"Eksport\",\"Import\",\"Pobor\",\"Produkcja\"\n";
+
+/**
+ * @brief Zaokrągla energię do trzech miejsc po przecinku.
+ */
+static double roundEnergy(double value) {
+    return std::round(value * 1000.0) / 1000.0;
+}
+
+/**
+ * @brief Tworzy generator o podanych parametrach.
+ */
+DataGenerator::DataGenerator(const GeneratorOptions& options)
+    : options(options), random(options.seed), malformedRandom(options.seed + 1), uniform(0.0, 1.0), timestamp(options.start), currentDay(-1) {
+    if (this->options.interval < 1) {
+        this->options.interval = 1;
+    }
+    if (this->options.maxGapLength < 1) {
+        this->options.maxGapLength = 1;
+    }
+    startDay(timestamp / MINUTES_PER_DAY);
+}
+
+/**
+ * @brief Losuje parametry pogody i pory roku dla nowego dnia.
+ */
+void DataGenerator::startDay(int64_t day) {
+    int year, month, dayOfMonth;
+    civilFromDays(day, year, month, dayOfMonth);
+    double dayOfYear = static_cast<double>(day - daysFromCivil(year, 1, 1));
+
+    // 1 w przesilenie letnie, -1 w przesilenie zimowe
+    double season = std::cos(2.0 * M_PI * (dayOfYear - 172.0) / 365.25);
+    daylight = 12.0 + 4.5 * season;
+    sunrise = 12.5 - daylight / 2.0;
+
+    double clouds = uniform(random);
+    solarPeak = options.peakPower * (0.65 + 0.35 * season) * (1.0 - 0.85 * clouds * clouds);
+    currentDay = day;
+}
+
+/**
+ * @brief Generuje kolejny rekord.
+ */
+bool DataGenerator::next(int64_t& timestamp, float values[CHANNEL_COUNT]) {
+    if (generatedCount >= options.recordCount) {
+        return false;
+    }
+
+    if (uniform(random) < options.gapRate) {
+        this->timestamp += options.interval * static_cast<int64_t>(1 + random() % options.maxGapLength);
+    }
+
+    int64_t day = this->timestamp / MINUTES_PER_DAY;
+    if (day != currentDay) {
+        startDay(day);
+    }
+
+    // Moc liczona w środku odstępu
+    double hour = static_cast<double>(this->timestamp - day * MINUTES_PER_DAY) / 60.0 + options.interval / 120.0;
+    double production = 0.0;
+    if (hour > sunrise && hour < sunrise + daylight) {
+        production = solarPeak * std::sin(M_PI * (hour - sunrise) / daylight) * (0.9 + 0.2 * uniform(random));
+    }
+
+    double load = options.baseLoad * (0.8 + 0.4 * uniform(random))
+        + 1.2 * std::exp(-(hour - 7.0) * (hour - 7.0) / 1.5)
+        + 2.0 * std::exp(-(hour - 19.5) * (hour - 19.5) / 3.0);
+    if (uniform(random) < 0.02) {
+        load += 2.5;
+    }
+
+    double hours = options.interval / 60.0;
+    double produkcja = roundEnergy(production * hours);
+    double pobor = roundEnergy(load * hours);
+    double autokonsumpcja = std::min(produkcja, pobor);
+
+    timestamp = this->timestamp;
+    values[AUTOKONSUMPCJA] = static_cast<float>(autokonsumpcja);
+    values[EKSPORT] = static_cast<float>(roundEnergy(produkcja - autokonsumpcja));
+    values[IMPORT] = static_cast<float>(roundEnergy(pobor - autokonsumpcja));
+    values[POBOR] = static_cast<float>(pobor);
+    values[PRODUKCJA] = static_cast<float>(produkcja);
+
+    this->timestamp += options.interval;
+    ++generatedCount;
+    return true;
+}
+
+/**
+ * @brief Dodaje wszystkie pozostałe rekordy do drzewa.
+ */
+void DataGenerator::fill(TreeData& treeData) {
+    int64_t recordTimestamp;
+    float values[CHANNEL_COUNT];
+    while (next(recordTimestamp, values)) {
+        treeData.addRecord(recordTimestamp, values);
+    }
+}
+
+/**
+ * @brief Zapisuje wszystkie pozostałe rekordy w formacie CSV eksportu z licznika.
+ */
+size_t DataGenerator::writeCsv(std::ostream& out) {
+    size_t written = sizeof(CSV_HEADER) - 1;
+    out.write(CSV_HEADER, static_cast<std::streamsize>(written));
+
+    int64_t recordTimestamp;
+    float values[CHANNEL_COUNT];
+    char date[DATE_BUFFER_SIZE];
+    char line[256];
+    while (next(recordTimestamp, values)) {
+        formatTimestamp(recordTimestamp, date, sizeof(date));
+
+        int length;
+        if (uniform(malformedRandom) < options.malformedRate) {
+            switch (malformedCount++ % 3) {
+            case 0:
+                length = std::snprintf(line, sizeof(line), "\"%s\",\"%.3f\",\"%.3f\",\"%.3f\",\"%.3f\"\n",
+                    date, values[0], values[1], values[2], values[3]);
+                break;
+            case 1:
+                length = std::snprintf(line, sizeof(line), "\"%s\",\"%.3f\",\"brak\",\"%.3f\",\"%.3f\",\"%.3f\"\n",
+                    date, values[0], values[2], values[3], values[4]);
+                break;
+            default:
+                length = std::snprintf(line, sizeof(line), "\"31.02.2020 25:70\",\"%.3f\",\"%.3f\",\"%.3f\",\"%.3f\",\"%.3f\"\n",
+                    values[0], values[1], values[2], values[3], values[4]);
+                break;
+            }
+            out.write(line, length);
+            written += static_cast<size_t>(length);
+        }
+
+        length = std::snprintf(line, sizeof(line), "\"%s\",\"%.3f\",\"%.3f\",\"%.3f\",\"%.3f\",\"%.3f\"\n",
+            date, values[0], values[1], values[2], values[3], values[4]);
+        out.write(line, length);
+        written += static_cast<size_t>(length);
+    }
+    return written;
+}
+
+/**
+ * @brief Zapisuje wszystkie pozostałe rekordy jako migawkę binarną (zob. `Snapshot`).
+ */
+void DataGenerator::writeSnapshot(std::ostream& out, bool compressed) {
+    TreeData treeData;
+    fill(treeData);
+    Snapshot::write(treeData, out, compressed);
+}
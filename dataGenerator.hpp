@@ -0,0 +1,113 @@
+/**
+ * @file dataGenerator.hpp
+ * @brief Deklaracja klasy `DataGenerator` tworzącej syntetyczne dane licznika z instalacją fotowoltaiczną.
+ */
+
+#ifndef DATAGENERATOR_HPP
+#define DATAGENERATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <random>
+
+#include "lineData.hpp"
+#include "treeData.hpp"
+
+/**
+ * @struct GeneratorOptions
+ * @brief Parametry generowanego zbioru danych.
+ */
+struct GeneratorOptions {
+    int64_t start = 26297280; /**< Znacznik czasu pierwszego rekordu (domyślnie 01.01.2020 00:00). */
+    size_t recordCount = 10000; /**< Liczba poprawnych rekordów do wygenerowania. */
+    int interval = 15; /**< Odstęp między rekordami w minutach (np. 15 lub 1). */
+    double gapRate = 0.0005; /**< Prawdopodobieństwo rozpoczęcia przerwy w danych przed rekordem. */
+    int maxGapLength = 96; /**< Maksymalna długość przerwy (w liczbie pominiętych odstępów). */
+    double malformedRate = 0.0005; /**< Prawdopodobieństwo dopisania błędnego wiersza w CSV przed rekordem. */
+    float peakPower = 8.0f; /**< Moc szczytowa instalacji PV w kW. */
+    float baseLoad = 0.4f; /**< Podstawowy pobór mocy w kW. */
+    uint32_t seed = 2020; /**< Ziarno generatora liczb losowych. */
+};
+
+/**
+ * @class DataGenerator
+ * @brief Generuje powtarzalny ciąg rekordów przypominający dane z licznika dwukierunkowego.
+ *
+ * Produkcja ma dobowy przebieg sinusoidalny z długością dnia i wysokością szczytu zależnymi
+ * od pory roku oraz losowym zachmurzeniem każdego dnia; w nocy wynosi dokładnie zero.
+ * Pobór składa się z obciążenia podstawowego oraz szczytu porannego i wieczornego.
+ * Autokonsumpcja, eksport i import wynikają z bilansu produkcji i poboru. Wartości są energią
+ * w kWh za odstęp, zaokrągloną do trzech miejsc po przecinku (tak jak w zapisie CSV).
+ *
+ * Te same opcje (w tym ziarno) dają zawsze te same dane.
+ */
+class DataGenerator {
+public:
+    /**
+     * @brief Tworzy generator o podanych parametrach.
+     */
+    explicit DataGenerator(const GeneratorOptions& options);
+
+    /**
+     * @brief Generuje kolejny rekord.
+     * @param timestamp Znacznik czasu rekordu (wyjście).
+     * @param values Wartości kanałów indeksowane `Channel` (wyjście).
+     * @return `false`, jeśli wygenerowano już wszystkie rekordy.
+     */
+    bool next(int64_t& timestamp, float values[CHANNEL_COUNT]);
+
+    /**
+     * @brief Dodaje wszystkie pozostałe rekordy do drzewa.
+     * @param treeData Drzewo, do którego dodawane są rekordy.
+     */
+    void fill(TreeData& treeData);
+
+    /**
+     * @brief Zapisuje wszystkie pozostałe rekordy w formacie CSV eksportu z licznika.
+     *
+     * Plik zaczyna się nagłówkiem, a z prawdopodobieństwem `malformedRate` przed rekordem
+     * dopisywany jest wiersz błędny (brakujące pole, litery w liczbie lub niepoprawna data).
+     *
+     * @param out Strumień wyjściowy.
+     * @return Liczba zapisanych bajtów.
+     */
+    size_t writeCsv(std::ostream& out);
+
+    /**
+     * @brief Zapisuje wszystkie pozostałe rekordy jako migawkę binarną (zob. `Snapshot`).
+     * @param out Strumień wyjściowy.
+     * @param compressed Czy kompresować kolumny.
+     */
+    void writeSnapshot(std::ostream& out, bool compressed = false);
+
+    /**
+     * @brief Zwraca liczbę wygenerowanych dotąd rekordów.
+     */
+    size_t getGeneratedCount() const { return generatedCount; }
+
+    /**
+     * @brief Zwraca liczbę błędnych wierszy zapisanych przez `writeCsv`.
+     */
+    size_t getMalformedCount() const { return malformedCount; }
+
+private:
+    /**
+     * @brief Losuje parametry pogody i pory roku dla nowego dnia.
+     */
+    void startDay(int64_t day);
+
+    GeneratorOptions options; /**< Parametry zbioru danych. */
+    std::mt19937 random; /**< Generator liczb losowych dla wartości rekordów. */
+    std::mt19937 malformedRandom; /**< Osobny generator dla błędnych wierszy, aby nie zmieniały rekordów. */
+    std::uniform_real_distribution<double> uniform; /**< Rozkład jednostajny na [0, 1). */
+    int64_t timestamp; /**< Znacznik czasu następnego rekordu. */
+    int64_t currentDay; /**< Numer dnia (od 01.01.1970), dla którego wylosowano parametry. */
+    double sunrise = 0.0; /**< Godzina wschodu słońca w bieżącym dniu. */
+    double daylight = 0.0; /**< Długość dnia w godzinach. */
+    double solarPeak = 0.0; /**< Moc szczytowa PV w bieżącym dniu (z zachmurzeniem) w kW. */
+    size_t generatedCount = 0; /**< Liczba wygenerowanych rekordów. */
+    size_t malformedCount = 0; /**< Liczba zapisanych błędnych wierszy. */
+};
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file dateTime.cpp
+ * @brief Implementacja konwersji dat używanych przez `TreeData` i `LineData`.
+ *
+ * Obliczenia kalendarzowe są czysto arytmetyczne (algorytm "days from civil"),
+ * dzięki czemu nie zależą od strefy czasowej ani od wywołań `mktime`.
+ */
+
+#include <algorithm>
+#include <cstdio>
+
+#include "dateTime.hpp"
+
+/**
+ * @brief Zwraca liczbę dni od 01.01.1970 dla podanej daty kalendarzowej.
+ */
+int64_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yearOfEra = year - era * 400;
+    const int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+ * @brief Zamienia liczbę dni od 01.01.1970 na datę kalendarzową.
+ */
+void civilFromDays(int64_t days, int& year, int& month, int& day) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const int64_t dayOfEra = days - era * 146097;
+    const int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int64_t mp = (5 * dayOfYear + 2) / 153;
+
+    day = static_cast<int>(dayOfYear - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yearOfEra + era * 400 + (month <= 2));
+}
+
+/**
+ * @brief Buduje znacznik czasu z poszczególnych składowych daty.
+ */
+int64_t makeTimestamp(int year, int month, int day, int hour, int minute) {
+    return daysFromCivil(year, month, day) * 1440 + hour * 60 + minute;
+}
+
+/**
+ * @brief Rozkłada znacznik czasu na składowe daty.
+ */
+void splitTimestamp(int64_t timestamp, int& year, int& month, int& day, int& hour, int& minute) {
+    int64_t days = timestamp / 1440;
+    int64_t minutes = timestamp % 1440;
+    if (minutes < 0) {
+        minutes += 1440;
+        --days;
+    }
+
+    civilFromDays(days, year, month, day);
+    hour = static_cast<int>(minutes / 60);
+    minute = static_cast<int>(minutes % 60);
+}
+
+/**
+ * @brief Zwraca liczbę dni w miesiącu.
+ */
+static int daysInMonth(int year, int month) {
+    static const int days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : days[month - 1];
+}
+
+/**
+ * @brief Odczytuje liczbę złożoną z `count` cyfr.
+ * @return `false`, jeśli któryś ze znaków nie jest cyfrą.
+ */
+static bool readDigits(const char* text, int count, int& value) {
+    value = 0;
+    for (int i = 0; i < count; ++i) {
+        unsigned digit = static_cast<unsigned>(text[i] - '0');
+        if (digit > 9) {
+            return false;
+        }
+        value = value * 10 + static_cast<int>(digit);
+    }
+    return true;
+}
+
+/**
+ * @brief Parsuje datę w stałym formacie "dd.mm.yyyy hh:mm" do znacznika czasu.
+ */
+bool parseTimestamp(const char* text, size_t length, int64_t& timestamp) {
+    if (length < 16 || text[2] != '.' || text[5] != '.' || text[10] != ' ' || text[13] != ':') {
+        return false;
+    }
+    for (size_t i = 16; i < length; ++i) {
+        if (text[i] != ' ' && text[i] != '\r' && text[i] != '\n' && text[i] != '\t') {
+            return false;
+        }
+    }
+
+    int day, month, year, hour, minute;
+    if (!readDigits(text, 2, day) || !readDigits(text + 3, 2, month) || !readDigits(text + 6, 4, year)
+        || !readDigits(text + 11, 2, hour) || !readDigits(text + 14, 2, minute)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month) || hour > 23 || minute > 59) {
+        return false;
+    }
+
+    timestamp = makeTimestamp(year, month, day, hour, minute);
+    return true;
+}
+
+/**
+ * @brief Parsuje datę w formacie "dd.mm.yyyy hh:mm" do znacznika czasu.
+ */
+bool parseTimestamp(const std::string& date, int64_t& timestamp) {
+    return parseTimestamp(date.data(), date.size(), timestamp);
+}
+
+/**
+ * @brief Formatuje znacznik czasu do postaci "dd.mm.yyyy hh:mm".
+ */
+std::string formatTimestamp(int64_t timestamp) {
+    char buffer[DATE_BUFFER_SIZE];
+    size_t length = formatTimestamp(timestamp, buffer, sizeof(buffer));
+    return std::string(buffer, length);
+}
+
+/**
+ * @brief Formatuje znacznik czasu do postaci "dd.mm.yyyy hh:mm" w podanym buforze.
+ */
+size_t formatTimestamp(int64_t timestamp, char* buffer, size_t size) {
+    int year, month, day, hour, minute;
+    splitTimestamp(timestamp, year, month, day, hour, minute);
+
+    int length = std::snprintf(buffer, size, "%02d.%02d.%04d %02d:%02d", day, month, year, hour, minute);
+    return length < 0 ? 0 : std::min(static_cast<size_t>(length), size - 1);
+}
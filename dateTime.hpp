@@ -0,0 +1,95 @@
+/**
+ * @file dateTime.hpp
+ * @brief Funkcje pomocnicze do konwersji dat między postacią tekstową a liczbowym znacznikiem czasu.
+ *
+ * Znacznik czasu to liczba minut od 01.01.1970 00:00 liczona w kalendarzu gregoriańskim,
+ * bez uwzględniania strefy czasowej. Daty tekstowe mają format "dd.mm.yyyy hh:mm".
+ */
+
+#ifndef DATETIME_HPP
+#define DATETIME_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+/** Wartość znacznika czasu oznaczająca datę, której nie udało się odczytać. */
+constexpr int64_t INVALID_TIMESTAMP = std::numeric_limits<int64_t>::min();
+
+/**
+ * @brief Zwraca liczbę dni od 01.01.1970 dla podanej daty kalendarzowej.
+ * @param year Rok.
+ * @param month Miesiąc (1-12).
+ * @param day Dzień (1-31).
+ * @return Liczba dni od początku epoki (może być ujemna).
+ */
+int64_t daysFromCivil(int year, int month, int day);
+
+/**
+ * @brief Zamienia liczbę dni od 01.01.1970 na datę kalendarzową.
+ * @param days Liczba dni od początku epoki.
+ * @param year Rok (wyjście).
+ * @param month Miesiąc 1-12 (wyjście).
+ * @param day Dzień 1-31 (wyjście).
+ */
+void civilFromDays(int64_t days, int& year, int& month, int& day);
+
+/**
+ * @brief Buduje znacznik czasu z poszczególnych składowych daty.
+ * @return Liczba minut od 01.01.1970 00:00.
+ */
+int64_t makeTimestamp(int year, int month, int day, int hour, int minute);
+
+/**
+ * @brief Rozkłada znacznik czasu na składowe daty.
+ * @param timestamp Liczba minut od 01.01.1970 00:00.
+ * @param year Rok (wyjście).
+ * @param month Miesiąc 1-12 (wyjście).
+ * @param day Dzień 1-31 (wyjście).
+ * @param hour Godzina 0-23 (wyjście).
+ * @param minute Minuta 0-59 (wyjście).
+ */
+void splitTimestamp(int64_t timestamp, int& year, int& month, int& day, int& hour, int& minute);
+
+/**
+ * @brief Parsuje datę w stałym formacie "dd.mm.yyyy hh:mm" do znacznika czasu.
+ *
+ * Parser nie korzysta z `std::get_time` ani `mktime`: odczytuje cyfry z ustalonych pozycji
+ * i sprawdza zakresy pól. Dopuszczalne są wyłącznie końcowe białe znaki (np. "\r").
+ *
+ * @param text Wskaźnik na początek daty.
+ * @param length Liczba dostępnych znaków.
+ * @param timestamp Wynikowy znacznik czasu (minuty od epoki).
+ * @return `true`, jeśli data została poprawnie odczytana.
+ */
+bool parseTimestamp(const char* text, size_t length, int64_t& timestamp);
+
+/**
+ * @brief Parsuje datę w formacie "dd.mm.yyyy hh:mm" do znacznika czasu.
+ * @param date Data w formie tekstowej.
+ * @param timestamp Wynikowy znacznik czasu (minuty od epoki).
+ * @return `true`, jeśli data została poprawnie odczytana.
+ */
+bool parseTimestamp(const std::string& date, int64_t& timestamp);
+
+/**
+ * @brief Formatuje znacznik czasu do postaci "dd.mm.yyyy hh:mm".
+ * @param timestamp Liczba minut od 01.01.1970 00:00.
+ * @return Data w formie tekstowej.
+ */
+std::string formatTimestamp(int64_t timestamp);
+
+/** Rozmiar bufora wystarczający dla `formatTimestamp` z kończącym zerem. */
+const size_t DATE_BUFFER_SIZE = 32;
+
+/**
+ * @brief Formatuje znacznik czasu do postaci "dd.mm.yyyy hh:mm" w podanym buforze, bez alokacji.
+ * @param timestamp Liczba minut od 01.01.1970 00:00.
+ * @param buffer Bufor wynikowy (co najmniej `DATE_BUFFER_SIZE` bajtów).
+ * @param size Rozmiar bufora.
+ * @return Długość zapisanego tekstu (bez kończącego zera).
+ */
+size_t formatTimestamp(int64_t timestamp, char* buffer, size_t size);
+
+#endif
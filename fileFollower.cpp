@@ -0,0 +1,123 @@
+/**
+ * @file fileFollower.cpp
+ * @brief Implementacja klasy `FileFollower`.
+ */
+
+#include <chrono>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "fileFollower.hpp"
+#include "mappedFile.hpp"
+
+/**
+ * @brief Tworzy obiekt śledzący plik (plik nie musi jeszcze istnieć).
+ */
+FileFollower::FileFollower(const std::string& path) : path(path) {
+#ifdef __linux__
+    notifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    watch();
+}
+
+/**
+ * @brief Destruktor zamykający obserwację pliku.
+ */
+FileFollower::~FileFollower() {
+#ifdef __linux__
+    if (notifyDescriptor >= 0) {
+        ::close(notifyDescriptor);
+    }
+#endif
+}
+
+/**
+ * @brief Rozpoczyna obserwację pliku przez inotify (jeśli jest dostępne).
+ */
+void FileFollower::watch() {
+#ifdef __linux__
+    if (notifyDescriptor >= 0 && watchDescriptor < 0) {
+        watchDescriptor = inotify_add_watch(notifyDescriptor, path.c_str(),
+            IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+    }
+#endif
+}
+
+/**
+ * @brief Wczytuje do drzewa pełne wiersze dopisane od poprzedniego odczytu.
+ */
+bool FileFollower::poll(TreeData& treeData, LoadStats& stats, size_t threadCount) {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats = LoadStats();
+
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    watch();
+
+    if (replaced || file.size() < offset) {
+        offset = 0;
+        replaced = false;
+    }
+
+    // Wczytywane są tylko wiersze zakończone znakiem nowej linii
+    const char* begin = file.data() + offset;
+    const char* end = file.data() + file.size();
+    while (end > begin && *(end - 1) != '\n') {
+        --end;
+    }
+    if (end == begin) {
+        return true;
+    }
+
+    stats = CsvLoader::loadBufferParallel(begin, end - begin, treeData, threadCount);
+    offset += static_cast<uint64_t>(end - begin);
+    return true;
+}
+
+/**
+ * @brief Czeka na zmianę pliku.
+ */
+bool FileFollower::waitForChange(int timeoutMilliseconds) {
+#ifdef __linux__
+    bool watching;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        watch();
+        watching = watchDescriptor >= 0;
+    }
+    if (watching) {
+        // Oczekiwanie odbywa się bez blokady, aby `poll` z innego wątku nie czekał na zmianę pliku
+        pollfd descriptor = {notifyDescriptor, POLLIN, 0};
+        if (::poll(&descriptor, 1, timeoutMilliseconds) <= 0) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = ::read(notifyDescriptor, buffer, sizeof(buffer))) > 0) {
+            for (char* position = buffer; position < buffer + length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(position);
+                if ((event->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED)) && watchDescriptor >= 0) {
+                    // Nowy plik pod tą samą ścieżką jest wczytywany od początku
+                    inotify_rm_watch(notifyDescriptor, watchDescriptor);
+                    watchDescriptor = -1;
+                    replaced = true;
+                }
+                position += sizeof(inotify_event) + event->len;
+            }
+        }
+        return true;
+    }
+#endif
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMilliseconds));
+    return true;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file fileFollower.hpp
+ * @brief Deklaracja klasy `FileFollower` wczytującej przyrostowo wiersze dopisywane do pliku CSV.
+ */
+
+#ifndef FILEFOLLOWER_HPP
+#define FILEFOLLOWER_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "csvLoader.hpp"
+#include "treeData.hpp"
+
+/**
+ * @class FileFollower
+ * @brief Śledzi rosnący plik CSV i wczytuje tylko wiersze dopisane od poprzedniego odczytu.
+ *
+ * Obiekt pamięta przesunięcie (w bajtach) końca ostatniego wczytanego pełnego wiersza.
+ * Niedokończony wiersz na końcu pliku jest pozostawiany do następnego odczytu. Jeśli plik
+ * stał się krótszy niż zapamiętane przesunięcie albo (pod Linuksem) został usunięty lub
+ * przeniesiony, jest wczytywany ponownie od początku.
+ *
+ * Oczekiwanie na zmiany korzysta z inotify pod Linuksem, a na pozostałych systemach
+ * sprowadza się do odpytywania co zadany czas.
+ *
+ * `poll` i `waitForChange` można wywoływać z różnych wątków (np. wczytanie z menu w czasie
+ * śledzenia w tle); stan obiektu chroniony jest muteksem.
+ */
+class FileFollower {
+public:
+    /**
+     * @brief Tworzy obiekt śledzący plik (plik nie musi jeszcze istnieć).
+     * @param path Ścieżka do pliku CSV.
+     */
+    explicit FileFollower(const std::string& path);
+
+    /**
+     * @brief Destruktor zamykający obserwację pliku.
+     */
+    ~FileFollower();
+
+    FileFollower(const FileFollower&) = delete;
+    FileFollower& operator=(const FileFollower&) = delete;
+
+    /**
+     * @brief Wczytuje do drzewa pełne wiersze dopisane od poprzedniego odczytu.
+     *
+     * Agregaty węzłów są aktualizowane przy dodawaniu rekordów; indeksy wartości
+     * zmienionych kwartałów należy odświeżyć przez `TreeData::buildIndexes`.
+     *
+     * @param treeData Drzewo, do którego dodawane są rekordy.
+     * @param stats Statystyki tego odczytu (wyjście).
+     * @param threadCount Liczba wątków parsujących (1 oznacza wczytanie sekwencyjne, 0 liczbę rdzeni).
+     * @return `false`, jeśli pliku nie udało się otworzyć.
+     */
+    bool poll(TreeData& treeData, LoadStats& stats, size_t threadCount = 1);
+
+    /**
+     * @brief Czeka na zmianę pliku.
+     * @param timeoutMilliseconds Maksymalny czas oczekiwania.
+     * @return `true`, jeśli plik mógł się zmienić (bez inotify: zawsze po upływie czasu).
+     */
+    bool waitForChange(int timeoutMilliseconds);
+
+    /**
+     * @brief Zwraca przesunięcie końca ostatniego wczytanego wiersza.
+     */
+    uint64_t getOffset() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return offset;
+    }
+
+    /**
+     * @brief Zwraca ścieżkę śledzonego pliku.
+     */
+    const std::string& getPath() const { return path; }
+
+private:
+    /**
+     * @brief Rozpoczyna obserwację pliku przez inotify (jeśli jest dostępne).
+     */
+    void watch();
+
+    std::string path; /**< Ścieżka do pliku. */
+    uint64_t offset = 0; /**< Przesunięcie końca ostatniego wczytanego wiersza. */
+    bool replaced = false; /**< Czy plik został usunięty lub przeniesiony od poprzedniego odczytu. */
+    int notifyDescriptor = -1; /**< Deskryptor inotify lub -1. */
+    int watchDescriptor = -1; /**< Deskryptor obserwacji pliku lub -1. */
+    mutable std::mutex mutex; /**< Chroni `offset`, `replaced` i `watchDescriptor`. */
+};
+
+#endif
@@ -0,0 +1,189 @@
+/**
+ * @file groupBy.cpp
+ * @brief Implementacja grupowania rekordów w przedziały czasowe.
+ */
+
+#include "dateTime.hpp"
+#include "groupBy.hpp"
+
+/**
+ * @brief Zwraca nazwę długości przedziału.
+ */
+const char* bucketSizeName(BucketSize bucket) {
+    static const char* const names[] = { "15min", "hour", "day", "week", "month", "year" };
+    return bucket >= BUCKET_15_MIN && bucket <= BUCKET_YEAR ? names[bucket] : "?";
+}
+
+/**
+ * @brief Odczytuje długość przedziału z nazwy.
+ */
+bool parseBucketSize(const std::string& name, BucketSize& bucket) {
+    for (int candidate = BUCKET_15_MIN; candidate <= BUCKET_YEAR; ++candidate) {
+        if (name == bucketSizeName(static_cast<BucketSize>(candidate))) {
+            bucket = static_cast<BucketSize>(candidate);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Zwraca nazwę funkcji agregującej.
+ */
+const char* aggregateFunctionName(AggregateFunction function) {
+    static const char* const names[] = { "sum", "avg", "min", "max", "count" };
+    return function >= FUNCTION_SUM && function <= FUNCTION_COUNT ? names[function] : "?";
+}
+
+/**
+ * @brief Odczytuje funkcję agregującą z nazwy.
+ */
+bool parseAggregateFunction(const std::string& name, AggregateFunction& function) {
+    for (int candidate = FUNCTION_SUM; candidate <= FUNCTION_COUNT; ++candidate) {
+        if (name == aggregateFunctionName(static_cast<AggregateFunction>(candidate))) {
+            function = static_cast<AggregateFunction>(candidate);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Dzielenie całkowite z zaokrągleniem w dół (także dla dat sprzed 1970).
+ */
+static int64_t floorDivide(int64_t value, int64_t divisor) {
+    return value / divisor - (value % divisor < 0 ? 1 : 0);
+}
+
+/**
+ * @brief Zwraca początek przedziału zawierającego podany znacznik czasu.
+ */
+int64_t bucketStart(int64_t timestamp, BucketSize bucket) {
+    int year, month, day, hour, minute;
+    switch (bucket) {
+    case BUCKET_15_MIN:
+        return floorDivide(timestamp, 15) * 15;
+    case BUCKET_HOUR:
+        return floorDivide(timestamp, 60) * 60;
+    case BUCKET_DAY:
+        return floorDivide(timestamp, 24 * 60) * 24 * 60;
+    case BUCKET_WEEK: {
+        // 01.01.1970 był czwartkiem, więc (dzień + 3) mod 7 to liczba dni od poniedziałku
+        int64_t days = floorDivide(timestamp, 24 * 60);
+        return (days - (days + 3 - floorDivide(days + 3, 7) * 7)) * 24 * 60;
+    }
+    case BUCKET_MONTH:
+        splitTimestamp(timestamp, year, month, day, hour, minute);
+        return makeTimestamp(year, month, 1, 0, 0);
+    case BUCKET_YEAR:
+    default:
+        splitTimestamp(timestamp, year, month, day, hour, minute);
+        return makeTimestamp(year, 1, 1, 0, 0);
+    }
+}
+
+/**
+ * @brief Zwraca ostatnią minutę przedziału zaczynającego się w `start`.
+ */
+int64_t bucketEnd(int64_t start, BucketSize bucket) {
+    int year, month, day, hour, minute;
+    switch (bucket) {
+    case BUCKET_15_MIN:
+        return start + 15 - 1;
+    case BUCKET_HOUR:
+        return start + 60 - 1;
+    case BUCKET_DAY:
+        return start + 24 * 60 - 1;
+    case BUCKET_WEEK:
+        return start + 7 * 24 * 60 - 1;
+    case BUCKET_MONTH:
+        splitTimestamp(start, year, month, day, hour, minute);
+        return (month == 12 ? makeTimestamp(year + 1, 1, 1, 0, 0) : makeTimestamp(year, month + 1, 1, 0, 0)) - 1;
+    case BUCKET_YEAR:
+    default:
+        splitTimestamp(start, year, month, day, hour, minute);
+        return makeTimestamp(year + 1, 1, 1, 0, 0) - 1;
+    }
+}
+
+/**
+ * @brief Dołącza agregat do ostatniego punktu serii lub rozpoczyna nowy punkt przedziału.
+ */
+void mergeIntoSeries(std::vector<RollupPoint>& points, int64_t start, const Aggregate& aggregate) {
+    if (aggregate.empty()) {
+        return;
+    }
+    if (points.empty() || points.back().timestamp != start) {
+        points.push_back({ start, aggregate });
+    } else {
+        points.back().aggregate.merge(aggregate);
+    }
+}
+
+/**
+ * @brief Dołącza do serii rosnący zakres rekordów zapisanych kolumnowo, dzieląc go na przedziały.
+ */
+void addColumnsToSeries(std::vector<RollupPoint>& points, BucketSize bucket,
+    const int64_t* timestamps, const float* const channels[CHANNEL_COUNT], size_t begin, size_t end) {
+    while (begin < end) {
+        int64_t start = bucketStart(timestamps[begin], bucket);
+        int64_t last = bucketEnd(start, bucket);
+        size_t partEnd = begin + 1;
+        while (partEnd < end && timestamps[partEnd] <= last) {
+            ++partEnd;
+        }
+
+        Aggregate part;
+        part.addColumns(channels, begin, partEnd);
+        mergeIntoSeries(points, start, part);
+        begin = partEnd;
+    }
+}
+
+/**
+ * @brief Wyznacza wybrane wartości wybranych kanałów dla każdego punktu serii.
+ */
+std::vector<GroupRow> selectGroups(const std::vector<RollupPoint>& points, const GroupBy& groupBy) {
+    std::vector<Channel> channels = groupBy.channels;
+    if (channels.empty()) {
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            channels.push_back(static_cast<Channel>(channel));
+        }
+    }
+    std::vector<AggregateFunction> functions = groupBy.functions;
+    if (functions.empty()) {
+        functions.push_back(FUNCTION_SUM);
+    }
+
+    std::vector<GroupRow> rows;
+    rows.reserve(points.size());
+    for (const RollupPoint& point : points) {
+        GroupRow row;
+        row.timestamp = point.timestamp;
+        row.count = point.aggregate.count;
+        row.values.reserve(channels.size() * functions.size());
+        for (Channel channel : channels) {
+            for (AggregateFunction function : functions) {
+                switch (function) {
+                case FUNCTION_SUM:
+                    row.values.push_back(point.aggregate.sum[channel]);
+                    break;
+                case FUNCTION_AVG:
+                    row.values.push_back(point.aggregate.average(channel));
+                    break;
+                case FUNCTION_MIN:
+                    row.values.push_back(point.aggregate.min[channel]);
+                    break;
+                case FUNCTION_MAX:
+                    row.values.push_back(point.aggregate.max[channel]);
+                    break;
+                case FUNCTION_COUNT:
+                    row.values.push_back(static_cast<double>(point.aggregate.count));
+                    break;
+                }
+            }
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file groupBy.hpp
+ * @brief Deklaracje grupowania rekordów w przedziały czasowe (kwadrans, godzina, doba, tydzień, miesiąc, rok).
+ */
+
+#ifndef GROUPBY_HPP
+#define GROUPBY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "aggregate.hpp"
+#include "lineData.hpp"
+
+/**
+ * @enum BucketSize
+ * @brief Długość przedziału czasowego grupowania.
+ *
+ * Tygodnie zaczynają się w poniedziałek o 00:00.
+ */
+enum BucketSize {
+    BUCKET_15_MIN,  ///< Kwadrans
+    BUCKET_HOUR,    ///< Godzina
+    BUCKET_DAY,     ///< Doba
+    BUCKET_WEEK,    ///< Tydzień (od poniedziałku)
+    BUCKET_MONTH,   ///< Miesiąc kalendarzowy
+    BUCKET_YEAR     ///< Rok kalendarzowy
+};
+
+/**
+ * @enum AggregateFunction
+ * @brief Wartość wyznaczana dla kanału w każdym przedziale.
+ */
+enum AggregateFunction {
+    FUNCTION_SUM,    ///< Suma
+    FUNCTION_AVG,    ///< Średnia
+    FUNCTION_MIN,    ///< Minimum
+    FUNCTION_MAX,    ///< Maksimum
+    FUNCTION_COUNT   ///< Liczba rekordów
+};
+
+/**
+ * @struct RollupPoint
+ * @brief Punkt serii zagregowanej: początek przedziału i agregaty jego rekordów.
+ */
+struct RollupPoint {
+    int64_t timestamp; /**< Początek przedziału (minuty od 01.01.1970). */
+    Aggregate aggregate; /**< Agregaty rekordów przedziału mieszczących się w zakresie zapytania. */
+};
+
+/**
+ * @struct GroupBy
+ * @brief Opis grupowania: długość przedziału, kanały i wyznaczane wartości.
+ *
+ * Pusta lista kanałów oznacza wszystkie kanały, a pusta lista funkcji - samą sumę.
+ */
+struct GroupBy {
+    BucketSize bucket = BUCKET_DAY; /**< Długość przedziału. */
+    std::vector<Channel> channels; /**< Kanały wyników. */
+    std::vector<AggregateFunction> functions; /**< Wartości wyznaczane dla każdego kanału. */
+};
+
+/**
+ * @struct GroupRow
+ * @brief Wynik grupowania dla jednego przedziału.
+ */
+struct GroupRow {
+    int64_t timestamp; /**< Początek przedziału (minuty od 01.01.1970). */
+    uint64_t count; /**< Liczba rekordów w przedziale. */
+    std::vector<double> values; /**< Wartości `values[kanał * liczba_funkcji + funkcja]` w kolejności z `GroupBy`. */
+};
+
+/**
+ * @brief Zwraca nazwę długości przedziału (`15min`, `hour`, `day`, `week`, `month`, `year`).
+ */
+const char* bucketSizeName(BucketSize bucket);
+
+/**
+ * @brief Odczytuje długość przedziału z nazwy.
+ * @return `false`, jeśli nazwa jest nieznana.
+ */
+bool parseBucketSize(const std::string& name, BucketSize& bucket);
+
+/**
+ * @brief Zwraca nazwę funkcji agregującej (`sum`, `avg`, `min`, `max`, `count`).
+ */
+const char* aggregateFunctionName(AggregateFunction function);
+
+/**
+ * @brief Odczytuje funkcję agregującą z nazwy.
+ * @return `false`, jeśli nazwa jest nieznana.
+ */
+bool parseAggregateFunction(const std::string& name, AggregateFunction& function);
+
+/**
+ * @brief Zwraca początek przedziału zawierającego podany znacznik czasu.
+ */
+int64_t bucketStart(int64_t timestamp, BucketSize bucket);
+
+/**
+ * @brief Zwraca ostatnią minutę przedziału zaczynającego się w `start`.
+ */
+int64_t bucketEnd(int64_t start, BucketSize bucket);
+
+/**
+ * @brief Dołącza agregat do ostatniego punktu serii lub rozpoczyna nowy punkt przedziału.
+ *
+ * Agregaty muszą być dołączane w kolejności chronologicznej; puste agregaty są pomijane.
+ *
+ * @param points Seria (wyjście, dopisywana).
+ * @param start Początek przedziału, do którego należy agregat.
+ * @param aggregate Agregat do dołączenia.
+ */
+void mergeIntoSeries(std::vector<RollupPoint>& points, int64_t start, const Aggregate& aggregate);
+
+/**
+ * @brief Dołącza do serii rosnący zakres rekordów zapisanych kolumnowo, dzieląc go na przedziały.
+ *
+ * Agregat każdej części liczony jest jednym przebiegiem po kolumnach (`Aggregate::addColumns`).
+ *
+ * @param points Seria (wyjście, dopisywana).
+ * @param bucket Długość przedziału.
+ * @param timestamps Kolumna znaczników czasu.
+ * @param channels Kolumny wartości kanałów (indeksowane `Channel`).
+ * @param begin Indeks pierwszego rekordu.
+ * @param end Indeks za ostatnim rekordem.
+ */
+void addColumnsToSeries(std::vector<RollupPoint>& points, BucketSize bucket,
+    const int64_t* timestamps, const float* const channels[CHANNEL_COUNT], size_t begin, size_t end);
+
+/**
+ * @brief Wyznacza wybrane wartości wybranych kanałów dla każdego punktu serii.
+ * @param points Seria agregatów.
+ * @param groupBy Kanały i funkcje wyników.
+ * @return Wiersze wyników w kolejności punktów.
+ */
+std::vector<GroupRow> selectGroups(const std::vector<RollupPoint>& points, const GroupBy& groupBy);
+
+#endif
@@ -6,11 +6,11 @@
  * deserializacji oraz ich prezentacji w postaci tekstowej.
  */
 
-#include <algorithm>
 #include <iostream>
-#include <sstream>
+#include <stdexcept>
 
 #include "lineData.hpp"
+#include "lineValidation.hpp"
 #include "logger.hpp"
 
 using namespace std;
@@ -18,32 +18,49 @@ using namespace std;
 /**
  * @brief Konstruktor tworzący obiekt `LineData` na podstawie ciągu znaków.
  * @param line Ciąg znaków reprezentujący pojedynczy rekord danych (CSV).
+ * @throws std::invalid_argument Jeśli wiersz nie przechodzi walidacji `scanLine`.
  */
 LineData::LineData(const string& line) {
-    vector<string> values;
-    stringstream ss(line);
-    string value;
+    ParsedLine parsed;
+    LineError error = scanLine(line.data(), line.data() + line.size(), parsed);
+    if (error != LINE_OK) {
+        throw invalid_argument(lineErrorMessage(error));
+    }
+
+    this->timestamp = parsed.timestamp;
+    this->date = formatTimestamp(parsed.timestamp);
+    this->autokonsumpcja = parsed.values[AUTOKONSUMPCJA];
+    this->eksport = parsed.values[EKSPORT];
+    this->import = parsed.values[IMPORT];
+    this->pobor = parsed.values[POBOR];
+    this->produkcja = parsed.values[PRODUKCJA];
 
-    while (getline(ss, value, ',')) {
-        value.erase(remove(value.begin(), value.end(), '\"'), value.end());
-        values.push_back(value);
+    if (logger.isEnabled(LOG_DEBUG)) {
+        logger.log(LOG_DEBUG, "Wczytano linie: " + this->printString());
     }
+}
 
-    this->date = values[0];
-    this->autokonsumpcja = stof(values[1]);
-    this->eksport = stof(values[2]);
-    this->import = stof(values[3]);
-    this->pobor = stof(values[4]);
-    this->produkcja = stof(values[5]);
+/**
+ * @brief Konstruktor tworzący obiekt `LineData` z gotowych wartości.
+ */
+LineData::LineData(const string& date, float autokonsumpcja, float eksport, float import, float pobor, float produkcja)
+    : date(date), autokonsumpcja(autokonsumpcja), eksport(eksport), import(import), pobor(pobor), produkcja(produkcja) {
+    updateTimestamp();
+}
 
-    logger.log("Wczytano linie: " + this->printString());
+/**
+ * @brief Konstruktor tworzący obiekt `LineData` ze znacznika czasu i wartości.
+ */
+LineData::LineData(int64_t timestamp, float autokonsumpcja, float eksport, float import, float pobor, float produkcja)
+    : date(formatTimestamp(timestamp)), timestamp(timestamp), autokonsumpcja(autokonsumpcja), eksport(eksport),
+      import(import), pobor(pobor), produkcja(produkcja) {
 }
 
 /**
  * @brief Konstruktor tworzący obiekt `LineData` na podstawie strumienia wejściowego.
  * @param in Strumień wejściowy do deserializacji obiektu.
  */
-LineData::LineData(ifstream& in) {
+LineData::LineData(istream& in) {
     deserialize(in);
 }
 
@@ -72,11 +89,62 @@ string LineData::printString() {
            + to_string(import) + " " + to_string(pobor) + " " + to_string(produkcja);
 }
 
+/**
+ * @brief Zwraca nazwę kanału.
+ */
+const char* channelName(Channel channel) {
+    static const char* const names[CHANNEL_COUNT] = { "autokonsumpcja", "eksport", "import", "pobor", "produkcja" };
+    return channel >= 0 && channel < CHANNEL_COUNT ? names[channel] : "?";
+}
+
+/**
+ * @brief Odczytuje kanał z nazwy lub numeru 1-5.
+ */
+bool parseChannel(const std::string& name, Channel& channel) {
+    if (name.size() == 1 && name[0] >= '1' && name[0] < '1' + CHANNEL_COUNT) {
+        channel = static_cast<Channel>(name[0] - '1');
+        return true;
+    }
+    if (name == "pobór") {
+        channel = POBOR;
+        return true;
+    }
+    for (int candidate = 0; candidate < CHANNEL_COUNT; ++candidate) {
+        if (name == channelName(static_cast<Channel>(candidate))) {
+            channel = static_cast<Channel>(candidate);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Zwraca wartość wskazanego kanału.
+ * @param channel Kanał pomiarowy.
+ * @return Wartość kanału.
+ */
+float LineData::getValue(Channel channel) const {
+    switch (channel) {
+    case AUTOKONSUMPCJA:
+        return autokonsumpcja;
+    case EKSPORT:
+        return eksport;
+    case IMPORT:
+        return import;
+    case POBOR:
+        return pobor;
+    case PRODUKCJA:
+        return produkcja;
+    default:
+        return 0.0f;
+    }
+}
+
 /**
  * @brief Serializuje dane do strumienia wyjściowego.
  * @param out Strumień wyjściowy, do którego dane będą zapisane.
  */
-void LineData::serialize(ofstream& out) const {
+void LineData::serialize(ostream& out) const {
     size_t dateSize = date.size();
     out.write(reinterpret_cast<const char*>(&dateSize), sizeof(dateSize));
     out.write(date.c_str(), dateSize);
@@ -91,7 +159,7 @@ void LineData::serialize(ofstream& out) const {
  * @brief Deserializuje dane ze strumienia wejściowego.
  * @param in Strumień wejściowy, z którego dane będą odczytane.
  */
-void LineData::deserialize(ifstream& in) {
+void LineData::deserialize(istream& in) {
     size_t dateSize;
     in.read(reinterpret_cast<char*>(&dateSize), sizeof(dateSize));
     date.resize(dateSize);
@@ -101,4 +169,14 @@ void LineData::deserialize(ifstream& in) {
     in.read(reinterpret_cast<char*>(&import), sizeof(import));
     in.read(reinterpret_cast<char*>(&pobor), sizeof(pobor));
     in.read(reinterpret_cast<char*>(&produkcja), sizeof(produkcja));
+    updateTimestamp();
+}
+
+/**
+ * @brief Oblicza znacznik czasu na podstawie daty tekstowej.
+ */
+void LineData::updateTimestamp() {
+    if (!parseTimestamp(date, timestamp)) {
+        timestamp = INVALID_TIMESTAMP;
+    }
 }
@@ -6,14 +6,46 @@
 #ifndef LINEDATA_HPP
 #define LINEDATA_HPP
 
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <sstream>
 #include <vector>
 
+#include "dateTime.hpp"
+
 using namespace std;
 
+/**
+ * @enum Channel
+ * @brief Enumeracja kanałów pomiarowych przechowywanych w każdym rekordzie.
+ *
+ * Wartości służą jako indeksy kolumn w strukturach kolumnowych (`TreeData`).
+ */
+enum Channel {
+    AUTOKONSUMPCJA = 0, ///< Autokonsumpcja
+    EKSPORT,            ///< Eksport
+    IMPORT,             ///< Import
+    POBOR,              ///< Pobór
+    PRODUKCJA,          ///< Produkcja
+    CHANNEL_COUNT       ///< Liczba kanałów
+};
+
+/**
+ * @brief Zwraca nazwę kanału (małymi literami, bez polskich znaków), np. "pobor".
+ * @param channel Kanał pomiarowy.
+ */
+const char* channelName(Channel channel);
+
+/**
+ * @brief Odczytuje kanał z nazwy (np. "eksport", także "pobór") lub numeru 1-5.
+ * @param name Nazwa lub numer kanału.
+ * @param channel Wynikowy kanał.
+ * @return `true`, jeśli nazwa została rozpoznana.
+ */
+bool parseChannel(const std::string& name, Channel& channel);
+
 /**
  * @class LineData
  * @brief Klasa reprezentująca pojedynczy rekord danych energetycznych.
@@ -24,9 +56,37 @@ using namespace std;
  */
 class LineData {
 public:
+    /**
+     * @brief Konstruktor domyślny tworzący pusty rekord.
+     */
+    LineData() = default;
+
+    /**
+     * @brief Konstruktor tworzący obiekt `LineData` z gotowych wartości.
+     * @param date Data w formacie "dd.mm.yyyy hh:mm".
+     * @param autokonsumpcja Wartość autokonsumpcji.
+     * @param eksport Wartość eksportu.
+     * @param import Wartość importu.
+     * @param pobor Wartość poboru.
+     * @param produkcja Wartość produkcji.
+     */
+    LineData(const string& date, float autokonsumpcja, float eksport, float import, float pobor, float produkcja);
+
+    /**
+     * @brief Konstruktor tworzący obiekt `LineData` ze znacznika czasu i wartości.
+     * @param timestamp Znacznik czasu (minuty od 01.01.1970 00:00), z którego formatowana jest data.
+     * @param autokonsumpcja Wartość autokonsumpcji.
+     * @param eksport Wartość eksportu.
+     * @param import Wartość importu.
+     * @param pobor Wartość poboru.
+     * @param produkcja Wartość produkcji.
+     */
+    LineData(int64_t timestamp, float autokonsumpcja, float eksport, float import, float pobor, float produkcja);
+
     /**
      * @brief Konstruktor tworzący obiekt `LineData` na podstawie ciągu znaków.
      * @param line Ciąg znaków reprezentujący pojedynczy rekord danych w formacie CSV.
+     * @throws std::invalid_argument Jeśli wiersz nie jest poprawnym rekordem danych.
      */
     explicit LineData(const string& line);
 
@@ -34,7 +94,7 @@ public:
      * @brief Konstruktor tworzący obiekt `LineData` na podstawie strumienia wejściowego.
      * @param in Strumień wejściowy używany do deserializacji obiektu.
      */
-    LineData(ifstream& in);
+    LineData(istream& in);
 
     /**
      * @brief Wyświetla dane na standardowe wyjście w pełnej postaci.
@@ -56,13 +116,13 @@ public:
      * @brief Serializuje dane do strumienia wyjściowego.
      * @param out Strumień wyjściowy, do którego dane będą zapisane.
      */
-    void serialize(ofstream& out) const;
+    void serialize(ostream& out) const;
 
     /**
      * @brief Deserializuje dane ze strumienia wejściowego.
      * @param in Strumień wejściowy, z którego dane będą odczytane.
      */
-    void deserialize(ifstream& in);
+    void deserialize(istream& in);
 
     /**
      * @brief Zwraca datę rekordu.
@@ -70,6 +130,12 @@ public:
      */
     string getDate() const { return date; }
 
+    /**
+     * @brief Zwraca znacznik czasu rekordu obliczony raz przy tworzeniu obiektu.
+     * @return Liczba minut od 01.01.1970 00:00 lub `INVALID_TIMESTAMP`, jeśli data jest niepoprawna.
+     */
+    int64_t getTimestamp() const { return timestamp; }
+
     /**
      * @brief Zwraca wartość autokonsumpcji.
      * @return Wartość autokonsumpcji.
@@ -100,13 +166,26 @@ public:
      */
     float getProdukcja() const { return produkcja; }
 
+    /**
+     * @brief Zwraca wartość wskazanego kanału.
+     * @param channel Kanał pomiarowy.
+     * @return Wartość kanału.
+     */
+    float getValue(Channel channel) const;
+
 private:
+    /**
+     * @brief Oblicza znacznik czasu na podstawie daty tekstowej.
+     */
+    void updateTimestamp();
+
     string date; ///< Data rekordu w formacie tekstowym.
-    float autokonsumpcja; ///< Wartość autokonsumpcji.
-    float eksport; ///< Wartość eksportu.
-    float import; ///< Wartość importu.
-    float pobor; ///< Wartość poboru.
-    float produkcja; ///< Wartość produkcji.
+    int64_t timestamp = INVALID_TIMESTAMP; ///< Znacznik czasu rekordu (minuty od epoki).
+    float autokonsumpcja = 0.0f; ///< Wartość autokonsumpcji.
+    float eksport = 0.0f; ///< Wartość eksportu.
+    float import = 0.0f; ///< Wartość importu.
+    float pobor = 0.0f; ///< Wartość poboru.
+    float produkcja = 0.0f; ///< Wartość produkcji.
 };
 
 #endif
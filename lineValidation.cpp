@@ -0,0 +1,243 @@
+/**
+ * @file lineValidation.cpp
+ * @brief Implementacja jednoprzebiegowej walidacji i podziału wierszy danych.
+ */
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LINEVALIDATION_SSE2 1
+#endif
+
+#include "dateTime.hpp"
+#include "lineValidation.hpp"
+
+/**
+ * @struct LineStructure
+ * @brief Położenie separatorów i cechy wiersza zebrane podczas skanowania.
+ */
+struct LineStructure {
+    const char* commas[CHANNEL_COUNT + 1]; /**< Pozycje pierwszych przecinków. */
+    int commaCount = 0; /**< Liczba znalezionych przecinków. */
+    bool invalidCharacter = false; /**< Czy wiersz zawiera litery lub znaki spoza ASCII. */
+};
+
+/**
+ * @brief Sprawdza, czy znak jest literą ASCII lub bajtem spoza ASCII.
+ */
+static inline bool isInvalidCharacter(unsigned char c) {
+    return static_cast<unsigned char>((c | 0x20) - 'a') < 26 || c >= 0x80;
+}
+
+/**
+ * @brief Zwraca numer najmłodszego ustawionego bitu.
+ */
+static inline int lowestBit(unsigned mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+/**
+ * @brief Zapisuje przecinek na pozycji `position`, jeśli mieści się w limicie.
+ */
+static inline void recordComma(LineStructure& structure, const char* position) {
+    if (structure.commaCount <= CHANNEL_COUNT) {
+        structure.commas[structure.commaCount] = position;
+    }
+    ++structure.commaCount;
+}
+
+/**
+ * @brief Skanuje wiersz, wyszukując przecinki i niedozwolone znaki.
+ */
+static void scanStructure(const char* begin, const char* end, LineStructure& structure) {
+    const char* position = begin;
+
+#ifdef LINEVALIDATION_SSE2
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i lowerCaseBit = _mm_set1_epi8(0x20);
+    const __m128i letterA = _mm_set1_epi8('a');
+    const __m128i letterRange = _mm_set1_epi8(25);
+
+    while (end - position >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+
+        __m128i letterOffset = _mm_sub_epi8(_mm_or_si128(block, lowerCaseBit), letterA);
+        __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letterOffset, letterRange), letterOffset);
+        unsigned invalidMask = static_cast<unsigned>(_mm_movemask_epi8(isLetter) | _mm_movemask_epi8(block));
+        if (invalidMask != 0) {
+            structure.invalidCharacter = true;
+        }
+
+        unsigned commaMask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, comma)));
+        while (commaMask != 0) {
+            recordComma(structure, position + lowestBit(commaMask));
+            commaMask &= commaMask - 1;
+        }
+
+        position += 16;
+    }
+#endif
+
+    for (; position < end; ++position) {
+        unsigned char c = static_cast<unsigned char>(*position);
+        if (c == ',') {
+            recordComma(structure, position);
+        } else if (isInvalidCharacter(c)) {
+            structure.invalidCharacter = true;
+        }
+    }
+}
+
+/**
+ * @brief Sprawdza, czy znak jest białym znakiem ASCII (jak `std::isspace` w locale "C").
+ */
+static inline bool isAsciiSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ * @brief Zawęża pole, pomijając otaczające je białe znaki.
+ */
+static inline void trim(const char*& begin, const char*& end) {
+    while (begin < end && isAsciiSpace(*begin)) {
+        ++begin;
+    }
+    while (begin < end && isAsciiSpace(*(end - 1))) {
+        --end;
+    }
+}
+
+/**
+ * @brief Zawęża pole do zawartości pomiędzy cudzysłowami (pomijając białe znaki wokół nich).
+ */
+static inline void unquote(const char*& begin, const char*& end) {
+    trim(begin, end);
+    if (begin < end && *begin == '"') {
+        ++begin;
+    }
+    if (begin < end && *(end - 1) == '"') {
+        --end;
+    }
+}
+
+/**
+ * @brief Odczytuje liczbę zmiennoprzecinkową zajmującą całe pole.
+ *
+ * Jak wcześniej używane `std::stof` dopuszcza białe znaki wokół liczby i znak '+',
+ * których `std::from_chars` nie akceptuje.
+ */
+static inline bool parseFloat(const char* begin, const char* end, float& value) {
+    trim(begin, end);
+    if (begin < end && *begin == '+') {
+        ++begin;
+        if (begin < end && *begin == '-') {
+            return false;
+        }
+    }
+    if (begin == end) {
+        return false;
+    }
+
+    auto result = std::from_chars(begin, end, value, std::chars_format::fixed);
+    return result.ec == std::errc() && result.ptr == end && std::isfinite(value);
+}
+
+/**
+ * @brief Sprawdza, czy wiersz zawiera słowo "Time" z nagłówka eksportu.
+ */
+static bool containsHeader(const char* begin, const char* end) {
+    static const char header[] = "Time";
+    for (const char* position = begin; end - position >= 4; ++position) {
+        if (std::memcmp(position, header, 4) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Waliduje wiersz i wyodrębnia z niego sześć pól w jednym przebiegu.
+ */
+LineError scanLine(const char* begin, const char* end, ParsedLine& parsed) {
+    if (begin < end && *(end - 1) == '\r') {
+        --end;
+    }
+    if (begin == end) {
+        return LINE_EMPTY;
+    }
+
+    LineStructure structure;
+    scanStructure(begin, end, structure);
+
+    if (structure.invalidCharacter) {
+        return containsHeader(begin, end) ? LINE_HEADER : LINE_INVALID_CHARACTER;
+    }
+    if (structure.commaCount != CHANNEL_COUNT) {
+        return LINE_FIELD_COUNT;
+    }
+
+    const char* fieldBegin = begin;
+    const char* fieldEnd = structure.commas[0];
+    unquote(fieldBegin, fieldEnd);
+    if (!parseTimestamp(fieldBegin, fieldEnd - fieldBegin, parsed.timestamp)) {
+        return LINE_INVALID_DATE;
+    }
+
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        fieldBegin = structure.commas[channel] + 1;
+        fieldEnd = channel + 1 < CHANNEL_COUNT ? structure.commas[channel + 1] : end;
+        unquote(fieldBegin, fieldEnd);
+        if (!parseFloat(fieldBegin, fieldEnd, parsed.values[channel])) {
+            return LINE_INVALID_NUMBER;
+        }
+    }
+
+    return LINE_OK;
+}
+
+/**
+ * @brief Zwraca opis kodu błędu walidacji.
+ */
+const char* lineErrorMessage(LineError error) {
+    switch (error) {
+    case LINE_OK:
+        return "Poprawna linia";
+    case LINE_EMPTY:
+        return "Pusta linia";
+    case LINE_HEADER:
+        return "Linia nagłówka";
+    case LINE_INVALID_CHARACTER:
+        return "Linia zawiera niedozwolone znaki";
+    case LINE_FIELD_COUNT:
+        return "Linia nie zawiera dokładnie 5 przecinków";
+    case LINE_INVALID_DATE:
+        return "Niepoprawna data";
+    case LINE_INVALID_NUMBER:
+        return "Niepoprawna wartość liczbowa";
+    default:
+        return "Nieznany błąd";
+    }
+}
+
+/**
+ * @brief Waliduje pojedynczy wiersz danych wejściowych i zapisuje błąd do loggera.
+ */
+bool lineValidation(const std::string& line) {
+    ParsedLine parsed;
+    LineError error = scanLine(line.data(), line.data() + line.size(), parsed);
+    if (error != LINE_OK) {
+        loggerError.log(std::string(lineErrorMessage(error)) + ": " + line);
+        return false;
+    }
+
+    return true;
+}
@@ -1,17 +1,63 @@
 /**
  * @file lineValidation.hpp
- * @brief Definicja funkcji `lineValidation` sprawdzającej poprawność danych wiersza.
+ * @brief Definicja funkcji `scanLine` walidującej i dzielącej wiersz danych w jednym przebiegu
+ *        oraz funkcji `lineValidation` sprawdzającej poprawność danych wiersza.
  */
 
 #ifndef LINEVALIDATION_HPP
 #define LINEVALIDATION_HPP
 
+#include <cstdint>
 #include <string>
-#include <cctype>
-#include <algorithm>
 
+#include "lineData.hpp"
 #include "logger.hpp"
 
+/**
+ * @enum LineError
+ * @brief Wynik walidacji pojedynczego wiersza danych wejściowych.
+ */
+enum LineError {
+    LINE_OK = 0,              ///< Wiersz jest poprawnym rekordem danych
+    LINE_EMPTY,               ///< Wiersz jest pusty
+    LINE_HEADER,              ///< Wiersz jest nagłówkiem ("Time")
+    LINE_INVALID_CHARACTER,   ///< Wiersz zawiera znaki alfabetyczne lub spoza ASCII
+    LINE_FIELD_COUNT,         ///< Wiersz nie zawiera dokładnie 5 przecinków
+    LINE_INVALID_DATE,        ///< Pierwsze pole nie jest datą "dd.mm.yyyy hh:mm"
+    LINE_INVALID_NUMBER       ///< Jedno z pól wartości nie jest liczbą
+};
+
+/**
+ * @struct ParsedLine
+ * @brief Pola odczytane z poprawnego wiersza danych.
+ */
+struct ParsedLine {
+    int64_t timestamp; /**< Znacznik czasu rekordu (minuty od 01.01.1970 00:00). */
+    float values[CHANNEL_COUNT]; /**< Wartości kanałów (indeksowane `Channel`). */
+};
+
+/**
+ * @brief Waliduje wiersz i wyodrębnia z niego sześć pól w jednym przebiegu.
+ *
+ * Wiersz jest przeglądany raz (blokami po 16 bajtów z użyciem SSE2, jeśli jest dostępne),
+ * przy czym jednocześnie wyszukiwane są przecinki, cudzysłowy i niedozwolone znaki. Następnie
+ * pola są odczytywane bezpośrednio z bufora: data stałoformatowym parserem, a liczby przez
+ * `std::from_chars`. Funkcja nie alokuje pamięci.
+ *
+ * @param begin Początek wiersza.
+ * @param end Koniec wiersza (bez znaku nowej linii; końcowe "\r" jest pomijane).
+ * @param parsed Odczytane pola (wyjście, ważne tylko dla `LINE_OK`).
+ * @return Kod wyniku walidacji.
+ */
+LineError scanLine(const char* begin, const char* end, ParsedLine& parsed);
+
+/**
+ * @brief Zwraca opis kodu błędu walidacji.
+ * @param error Kod wyniku walidacji.
+ * @return Opis w formie tekstowej.
+ */
+const char* lineErrorMessage(LineError error);
+
 /**
  * @brief Waliduje pojedynczy wiersz danych wejściowych.
  *
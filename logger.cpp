@@ -3,28 +3,23 @@
  * @brief Implementacja klasy Logger do obsługi logowania zdarzeń w aplikacji.
  */
 
+#include <chrono>
 #include <iomanip>
-#include <ctime>
 #include <cstdio>
 #include <sstream>
+#include <stdexcept>
 
 #include "logger.hpp"
 
 // Globalne instancje loggerów
 Logger logger("log"); /**< Logger dla standardowych wiadomości. */
 Logger loggerError("log_error"); /**< Logger dla wiadomości o błędach. */
-int loggerErrorCount = 0; /**< Licznik błędów zapisanych w loggerze błędów. */
+std::atomic<int> loggerErrorCount(0); /**< Licznik błędów zapisanych w loggerze błędów. */
 
 /**
- * @brief Konstruktor klasy Logger.
- * 
- * Tworzy logger z unikalną nazwą pliku zawierającą datę i czas utworzenia.
- * 
- * @param filename Nazwa pliku bazowego do generowania nazw plików logów.
- * @throws std::runtime_error Jeśli nie można otworzyć pliku logów.
+ * @brief Zamienia czas na strukturę `tm` w lokalnej strefie czasowej.
  */
-Logger::Logger(const std::string& filename) {
-    auto t = std::time(nullptr);
+static std::tm toLocalTime(std::time_t t) {
     std::tm tm;
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -33,6 +28,42 @@ Logger::Logger(const std::string& filename) {
     localtime_r(&t, &tm);
 #endif
 
+    return tm;
+}
+
+/**
+ * @brief Zwraca nazwę poziomu wiadomości.
+ */
+static const char* levelName(LogLevel level) {
+    switch (level) {
+    case LOG_DEBUG:
+        return "DEBUG";
+    case LOG_INFO:
+        return "INFO";
+    case LOG_WARNING:
+        return "WARNING";
+    case LOG_ERROR:
+        return "ERROR";
+    default:
+        return "?";
+    }
+}
+
+/**
+ * @brief Konstruktor klasy Logger.
+ *
+ * Tworzy logger z unikalną nazwą pliku zawierającą datę i czas utworzenia
+ * i uruchamia wątek zapisujący.
+ *
+ * @param filename Nazwa pliku bazowego do generowania nazw plików logów.
+ * @param level Minimalny poziom zapisywanych wiadomości.
+ * @throws std::runtime_error Jeśli nie można otworzyć pliku logów.
+ */
+Logger::Logger(const std::string& filename, LogLevel level)
+    : minimumLevel(level), slots(new Slot[CAPACITY]), enqueuePosition(0), dequeuePosition(0),
+      writtenCount(0), stopping(false), writerSleeping(false), cachedTime(-1) {
+    std::tm tm = toLocalTime(std::time(nullptr));
+
     std::ostringstream oss;
     oss << filename << "_" << std::put_time(&tm, "%d%m%Y_%H%M%S") << ".txt";
     std::string datedFilename = oss.str();
@@ -45,14 +76,30 @@ Logger::Logger(const std::string& filename) {
     if (!logFile.is_open()) {
         throw std::runtime_error("Nie można otworzyć pliku log");
     }
+
+    for (size_t i = 0; i < CAPACITY; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    writer = std::thread(&Logger::writerLoop, this);
 }
 
 /**
  * @brief Destruktor klasy Logger.
- * 
- * Zamyka plik logów, jeśli jest otwarty.
+ *
+ * Zapisuje oczekujące wiadomości, zatrzymuje wątek zapisujący i zamyka plik logów.
  */
 Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping.store(true);
+    }
+    wakeCondition.notify_one();
+
+    if (writer.joinable()) {
+        writer.join();
+    }
+
     if (logFile.is_open()) {
         logFile.close();
     }
@@ -60,26 +107,131 @@ Logger::~Logger() {
 
 /**
  * @brief Zapisuje wiadomość do pliku logów z dołączonym znacznikiem czasowym.
- * 
+ *
  * Jeśli loggerem jest `loggerError`, zwiększa licznik błędów `loggerErrorCount`.
- * 
+ *
  * @param message Wiadomość do zapisania w pliku logów.
  */
 void Logger::log(const std::string& message) {
-    if (logFile.is_open()) {
-        auto t = std::time(nullptr);
-        std::tm tm;
+    log(this == &loggerError ? LOG_ERROR : LOG_INFO, message);
+}
 
-#if defined(_WIN32) || defined(_WIN64)
-        localtime_s(&tm, &t);
-#else
-        localtime_r(&t, &tm);
-#endif
+/**
+ * @brief Przekazuje wiadomość do bufora pierścieniowego.
+ *
+ * Gdy bufor jest pełny, wywołujący ustępuje procesor do czasu zwolnienia miejsca,
+ * więc wiadomości nie są gubione.
+ *
+ * @param level Poziom wiadomości.
+ * @param message Wiadomość do zapisania w pliku logów.
+ */
+void Logger::log(LogLevel level, std::string message) {
+    if (this == &loggerError) {
+        ++loggerErrorCount;
+    }
+    if (!isEnabled(level)) {
+        return;
+    }
+
+    size_t position = enqueuePosition.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[position & (CAPACITY - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
 
-        logFile << std::put_time(&tm, "%d.%m.%Y %H:%M:%S") << " " << message << std::endl;
+        if (difference == 0) {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            std::this_thread::yield();
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        } else {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
     }
 
-    if (this == &loggerError) {
-        ++loggerErrorCount;
+    slot->level = level;
+    slot->time = std::time(nullptr);
+    slot->message = std::move(message);
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    if (writerSleeping.load(std::memory_order_relaxed)) {
+        wakeCondition.notify_one();
+    }
+}
+
+/**
+ * @brief Czeka, aż wszystkie dotychczas przekazane wiadomości zostaną zapisane do pliku.
+ */
+void Logger::flush() {
+    size_t target = enqueuePosition.load(std::memory_order_acquire);
+    while (writtenCount.load(std::memory_order_acquire) < target) {
+        wakeCondition.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+/**
+ * @brief Zwraca sformatowany znacznik czasu, korzystając z pamięci podręcznej.
+ */
+const std::string& Logger::formatTime(std::time_t time) {
+    if (time != cachedTime) {
+        std::tm tm = toLocalTime(time);
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%d.%m.%Y %H:%M:%S", &tm);
+        cachedTimeText = buffer;
+        cachedTime = time;
+    }
+
+    return cachedTimeText;
+}
+
+/**
+ * @brief Zapisuje do pliku wszystkie wiadomości oczekujące w buforze.
+ * @return Liczba zapisanych wiadomości.
+ */
+size_t Logger::drain() {
+    size_t count = 0;
+
+    while (true) {
+        Slot& slot = slots[dequeuePosition & (CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) {
+            break;
+        }
+
+        logFile << formatTime(slot.time) << " [" << levelName(slot.level) << "] " << slot.message << '\n';
+        slot.message.clear();
+        slot.sequence.store(dequeuePosition + CAPACITY, std::memory_order_release);
+        ++dequeuePosition;
+        ++count;
+    }
+
+    if (count > 0) {
+        logFile.flush();
+        writtenCount.fetch_add(count, std::memory_order_release);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Pętla wątku zapisującego: zapisuje wiadomości partiami aż do zamknięcia loggera.
+ */
+void Logger::writerLoop() {
+    while (true) {
+        if (drain() > 0) {
+            continue;
+        }
+        if (stopping.load()) {
+            drain();
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        writerSleeping.store(true);
+        wakeCondition.wait_for(lock, std::chrono::milliseconds(20));
+        writerSleeping.store(false);
     }
 }
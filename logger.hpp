@@ -6,46 +6,140 @@
 #ifndef LOGGER_HPP
 #define LOGGER_HPP
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <ctime>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+
+/**
+ * @enum LogLevel
+ * @brief Poziomy ważności wiadomości zapisywanych w logach.
+ */
+enum LogLevel {
+    LOG_DEBUG = 0,  ///< Szczegółowe informacje diagnostyczne (np. każda wczytana linia)
+    LOG_INFO,       ///< Informacje o przebiegu programu
+    LOG_WARNING,    ///< Ostrzeżenia
+    LOG_ERROR       ///< Błędy
+};
 
 /**
  * @class Logger
  * @brief Klasa do zarządzania logowaniem zdarzeń w aplikacji.
- * 
- * Klasa ta pozwala na zapis wiadomości do pliku logów z dołączonym znacznikiem czasowym. 
+ *
+ * Klasa ta pozwala na zapis wiadomości do pliku logów z dołączonym znacznikiem czasowym.
  * Istnieją dwa rodzaje loggerów: jeden do logowania standardowych wiadomości i drugi do logowania błędów.
+ *
+ * Wiadomości są przekazywane przez bezblokadowy bufor pierścieniowy do wątku zapisującego,
+ * który zapisuje je do pliku partiami, formatując znacznik czasu tylko raz na sekundę.
+ * Wiadomości poniżej ustawionego poziomu są odrzucane; wywołujący powinien sprawdzić
+ * `isEnabled` przed kosztownym budowaniem treści wiadomości.
  */
 class Logger {
 public:
     /**
      * @brief Konstruktor klasy Logger.
-     * 
+     *
      * Tworzy logger z unikalną nazwą pliku zawierającą datę i czas utworzenia.
-     * 
+     *
      * @param filename Nazwa pliku bazowego do generowania nazw plików logów.
+     * @param level Minimalny poziom zapisywanych wiadomości.
      */
-    Logger(const std::string& filename);
+    Logger(const std::string& filename, LogLevel level = LOG_INFO);
 
     /**
      * @brief Destruktor klasy Logger.
-     * 
-     * Zamyka plik logów, jeśli jest otwarty.
+     *
+     * Zapisuje oczekujące wiadomości, zatrzymuje wątek zapisujący i zamyka plik logów.
      */
     ~Logger();
 
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief Sprawdza, czy wiadomości o danym poziomie są zapisywane.
+     * @param level Poziom wiadomości.
+     * @return `true`, jeśli wiadomość zostałaby zapisana.
+     */
+    bool isEnabled(LogLevel level) const { return level >= minimumLevel.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Ustawia minimalny poziom zapisywanych wiadomości.
+     * @param level Nowy poziom minimalny.
+     */
+    void setLevel(LogLevel level) { minimumLevel.store(level, std::memory_order_relaxed); }
+
     /**
      * @brief Zapisuje wiadomość do pliku logów.
-     * 
-     * Zawiera znaczniki czasowe, które są dodawane przed każdą wiadomością. Jeśli logger jest używany do zapisu błędów, 
-     * to zwiększa licznik błędów.
-     * 
+     *
+     * Zawiera znaczniki czasowe, które są dodawane przed każdą wiadomością. Jeśli logger jest używany do zapisu błędów,
+     * to zwiększa licznik błędów. Metoda może być wywoływana jednocześnie z wielu wątków.
+     * Wiadomość otrzymuje poziom `LOG_ERROR` w loggerze błędów i `LOG_INFO` w pozostałych.
+     *
      * @param message Wiadomość do zapisania w pliku logów.
      */
     void log(const std::string& message);
 
+    /**
+     * @brief Zapisuje wiadomość o podanym poziomie do pliku logów.
+     * @param level Poziom wiadomości.
+     * @param message Wiadomość do zapisania w pliku logów.
+     */
+    void log(LogLevel level, std::string message);
+
+    /**
+     * @brief Czeka, aż wszystkie dotychczas przekazane wiadomości zostaną zapisane do pliku.
+     */
+    void flush();
+
 private:
+    /**
+     * @struct Slot
+     * @brief Miejsce w buforze pierścieniowym.
+     */
+    struct Slot {
+        std::atomic<size_t> sequence; /**< Numer sekwencyjny określający stan miejsca. */
+        LogLevel level; /**< Poziom wiadomości. */
+        std::time_t time; /**< Czas przekazania wiadomości. */
+        std::string message; /**< Treść wiadomości. */
+    };
+
+    /**
+     * @brief Pętla wątku zapisującego.
+     */
+    void writerLoop();
+
+    /**
+     * @brief Zapisuje do pliku wszystkie wiadomości oczekujące w buforze.
+     * @return Liczba zapisanych wiadomości.
+     */
+    size_t drain();
+
+    /**
+     * @brief Zwraca sformatowany znacznik czasu, korzystając z pamięci podręcznej.
+     */
+    const std::string& formatTime(std::time_t time);
+
+    static const size_t CAPACITY = 8192; /**< Pojemność bufora (potęga dwójki). */
+
     std::ofstream logFile; /**< Strumień do zapisu w pliku logów. */
+    std::atomic<int> minimumLevel; /**< Minimalny poziom zapisywanych wiadomości. */
+    std::unique_ptr<Slot[]> slots; /**< Bufor pierścieniowy wiadomości. */
+    std::atomic<size_t> enqueuePosition; /**< Następna pozycja do zapisu przez producentów. */
+    size_t dequeuePosition; /**< Następna pozycja do odczytu przez wątek zapisujący. */
+    std::atomic<size_t> writtenCount; /**< Liczba wiadomości zapisanych do pliku. */
+    std::atomic<bool> stopping; /**< Czy logger jest zamykany. */
+    std::atomic<bool> writerSleeping; /**< Czy wątek zapisujący czeka na nowe wiadomości. */
+    std::mutex wakeMutex; /**< Muteks zmiennej warunkowej budzącej wątek zapisujący. */
+    std::condition_variable wakeCondition; /**< Budzi wątek zapisujący. */
+    std::time_t cachedTime; /**< Sekunda, dla której sformatowano `cachedTimeText`. */
+    std::string cachedTimeText; /**< Sformatowany znacznik czasu. */
+    std::thread writer; /**< Wątek zapisujący wiadomości do pliku. */
 };
 
 /** Instancja loggera do standardowych logów. */
@@ -55,6 +149,6 @@ extern Logger logger;
 extern Logger loggerError;
 
 /** Licznik błędów zapisanych w loggerze błędów. */
-extern int loggerErrorCount;
+extern std::atomic<int> loggerErrorCount;
 
 #endif
@@ -1,5 +1,9 @@
 #include "app.hpp"
+#include "batchMode.hpp"
 
-int main() {
+int main(int argc, char* argv[]) {
+  if (argc > 1) {
+    return BatchMode::run(argc, argv);
+  }
   return App::run(); 
 }
@@ -0,0 +1,158 @@
+/**
+ * @file mappedFile.cpp
+ * @brief Implementacja klasy `MappedFile` dla systemów POSIX i Windows.
+ */
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mappedFile.hpp"
+
+/**
+ * @brief Destruktor zwalniający odwzorowanie.
+ */
+MappedFile::~MappedFile() {
+    close();
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+
+/**
+ * @brief Odwzorowuje plik w pamięci przy użyciu `CreateFileMapping`.
+ * @param path Ścieżka do pliku.
+ * @return `true`, jeśli plik został otwarty.
+ */
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+    opened = true;
+    if (mappedSize == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+
+    mappedData = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (mappedData == nullptr) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Zwalnia odwzorowanie pliku i zamyka uchwyty.
+ */
+void MappedFile::close() {
+    if (mappedData != nullptr) {
+        UnmapViewOfFile(mappedData);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+    }
+    if (fileHandle != nullptr) {
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+    }
+
+    mappedData = nullptr;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+    mappedSize = 0;
+    opened = false;
+}
+
+/**
+ * @brief Na Windows sekwencyjny odczyt deklarowany jest przy otwarciu pliku.
+ */
+void MappedFile::adviseSequential() const {
+}
+
+#else
+
+/**
+ * @brief Odwzorowuje plik w pamięci przy użyciu `mmap`.
+ * @param path Ścieżka do pliku.
+ * @return `true`, jeśli plik został otwarty.
+ */
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    mappedSize = static_cast<size_t>(fileStat.st_size);
+    opened = true;
+    if (mappedSize == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* mapping = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        mappedSize = 0;
+        opened = false;
+        return false;
+    }
+
+    mappedData = static_cast<const char*>(mapping);
+    return true;
+}
+
+/**
+ * @brief Zwalnia odwzorowanie pliku.
+ */
+void MappedFile::close() {
+    if (mappedData != nullptr) {
+        munmap(const_cast<char*>(mappedData), mappedSize);
+    }
+
+    mappedData = nullptr;
+    mappedSize = 0;
+    opened = false;
+}
+
+/**
+ * @brief Informuje jądro o sekwencyjnym dostępie, co zwiększa odczyt z wyprzedzeniem.
+ */
+void MappedFile::adviseSequential() const {
+    if (mappedData != nullptr) {
+        posix_madvise(const_cast<char*>(mappedData), mappedSize, POSIX_MADV_SEQUENTIAL);
+    }
+}
+
+#endif
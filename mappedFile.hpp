@@ -0,0 +1,76 @@
+/**
+ * @file mappedFile.hpp
+ * @brief Deklaracja klasy `MappedFile` odwzorowującej plik w pamięci tylko do odczytu.
+ */
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Plik odwzorowany w pamięci (mmap / MapViewOfFile) w trybie tylko do odczytu.
+ *
+ * Zawartość pliku jest dostępna bezpośrednio przez wskaźnik `data()`, bez kopiowania
+ * do buforów programu. Obiekt zamyka odwzorowanie w destruktorze.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Tworzy obiekt bez otwartego pliku.
+     */
+    MappedFile() = default;
+
+    /**
+     * @brief Destruktor zwalniający odwzorowanie.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Odwzorowuje plik w pamięci.
+     * @param path Ścieżka do pliku.
+     * @return `true`, jeśli plik został otwarty (pusty plik daje `size() == 0`).
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Zwalnia odwzorowanie pliku.
+     */
+    void close();
+
+    /**
+     * @brief Informuje system, że plik będzie czytany sekwencyjnie.
+     */
+    void adviseSequential() const;
+
+    /**
+     * @brief Zwraca wskaźnik na początek zawartości pliku.
+     */
+    const char* data() const { return mappedData; }
+
+    /**
+     * @brief Zwraca rozmiar pliku w bajtach.
+     */
+    size_t size() const { return mappedSize; }
+
+    /**
+     * @brief Sprawdza, czy plik jest otwarty.
+     */
+    bool isOpen() const { return opened; }
+
+private:
+    const char* mappedData = nullptr; /**< Początek odwzorowanej zawartości. */
+    size_t mappedSize = 0; /**< Rozmiar odwzorowanej zawartości. */
+    bool opened = false; /**< Czy plik jest otwarty. */
+#if defined(_WIN32) || defined(_WIN64)
+    void* fileHandle = nullptr; /**< Uchwyt pliku (HANDLE). */
+    void* mappingHandle = nullptr; /**< Uchwyt odwzorowania (HANDLE). */
+#endif
+};
+
+#endif
@@ -0,0 +1,215 @@
+/**
+ * @file predicate.cpp
+ * @brief Implementacja klasy `Predicate`.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "predicate.hpp"
+
+/**
+ * @brief Warunek low <= kanał <= high.
+ */
+Predicate Predicate::between(Channel channel, float low, float high) {
+    Predicate predicate;
+    predicate.terms.push_back({ TERM_RANGE, channel, low, high });
+    predicate.depth = 1;
+    return predicate;
+}
+
+/**
+ * @brief Warunek kanał < value.
+ */
+Predicate Predicate::less(Channel channel, float value) {
+    return between(channel, -std::numeric_limits<float>::infinity(),
+        std::nextafter(value, -std::numeric_limits<float>::infinity()));
+}
+
+/**
+ * @brief Warunek kanał <= value.
+ */
+Predicate Predicate::lessEqual(Channel channel, float value) {
+    return between(channel, -std::numeric_limits<float>::infinity(), value);
+}
+
+/**
+ * @brief Warunek kanał > value.
+ */
+Predicate Predicate::greater(Channel channel, float value) {
+    return between(channel, std::nextafter(value, std::numeric_limits<float>::infinity()),
+        std::numeric_limits<float>::infinity());
+}
+
+/**
+ * @brief Warunek kanał >= value.
+ */
+Predicate Predicate::greaterEqual(Channel channel, float value) {
+    return between(channel, value, std::numeric_limits<float>::infinity());
+}
+
+/**
+ * @brief Warunek kanał == value.
+ */
+Predicate Predicate::equal(Channel channel, float value) {
+    return between(channel, value, value);
+}
+
+/**
+ * @brief Koniunkcja dwóch warunków.
+ */
+Predicate Predicate::operator&&(const Predicate& other) const {
+    return combine(*this, other, TERM_AND);
+}
+
+/**
+ * @brief Alternatywa dwóch warunków.
+ */
+Predicate Predicate::operator||(const Predicate& other) const {
+    return combine(*this, other, TERM_OR);
+}
+
+/**
+ * @brief Łączy dwa warunki operatorem `kind`.
+ *
+ * Warunek pusty (zawsze spełniony) jest elementem neutralnym koniunkcji i pochłania alternatywę.
+ */
+Predicate Predicate::combine(const Predicate& left, const Predicate& right, TermKind kind) {
+    if (left.terms.empty() || right.terms.empty()) {
+        if (kind == TERM_OR) {
+            return Predicate();
+        }
+        return left.terms.empty() ? right : left;
+    }
+
+    Predicate predicate;
+    predicate.terms.reserve(left.terms.size() + right.terms.size() + 1);
+    predicate.terms.insert(predicate.terms.end(), left.terms.begin(), left.terms.end());
+    predicate.terms.insert(predicate.terms.end(), right.terms.begin(), right.terms.end());
+    predicate.terms.push_back({ kind, AUTOKONSUMPCJA, 0.0f, 0.0f });
+    predicate.depth = std::max(left.depth, right.depth + 1);
+    return predicate;
+}
+
+/**
+ * @brief Ocenia wyrażenie na stosie wartości logicznych wyliczanych funkcją `evaluateRange`.
+ * @param evaluateRange Funkcja `bool(const Term&)` oceniająca pojedynczy przedział.
+ */
+template <typename RangeFn>
+bool Predicate::evaluateTerms(RangeFn&& evaluateRange) const {
+    if (terms.empty()) {
+        return true;
+    }
+
+    char local[32];
+    std::vector<char> heap;
+    char* stack = local;
+    if (depth > sizeof(local)) {
+        heap.resize(depth);
+        stack = heap.data();
+    }
+
+    size_t top = 0;
+    for (const Term& term : terms) {
+        switch (term.kind) {
+        case TERM_RANGE:
+            stack[top++] = evaluateRange(term);
+            break;
+        case TERM_AND:
+            --top;
+            stack[top - 1] = stack[top - 1] && stack[top];
+            break;
+        case TERM_OR:
+            --top;
+            stack[top - 1] = stack[top - 1] || stack[top];
+            break;
+        }
+    }
+
+    return stack[0] != 0;
+}
+
+/**
+ * @brief Sprawdza, czy warunek jest spełniony dla pojedynczego rekordu.
+ */
+bool Predicate::matches(const float values[CHANNEL_COUNT]) const {
+    return evaluateTerms([values](const Term& term) {
+        return values[term.channel] >= term.low && values[term.channel] <= term.high;
+    });
+}
+
+/**
+ * @brief Sprawdza, czy jakiś rekord o statystykach `aggregate` może spełnić warunek.
+ */
+bool Predicate::mayMatch(const Aggregate& aggregate) const {
+    if (aggregate.empty()) {
+        return false;
+    }
+    return evaluateTerms([&aggregate](const Term& term) {
+        return aggregate.max[term.channel] >= term.low && aggregate.min[term.channel] <= term.high;
+    });
+}
+
+/**
+ * @brief Sprawdza, czy wszystkie rekordy o statystykach `aggregate` spełniają warunek.
+ */
+bool Predicate::matchesAll(const Aggregate& aggregate) const {
+    return evaluateTerms([&aggregate](const Term& term) {
+        return aggregate.min[term.channel] >= term.low && aggregate.max[term.channel] <= term.high;
+    });
+}
+
+/**
+ * @brief Sprawdza warunek dla zakresu rekordów zapisanych kolumnowo.
+ *
+ * Każdy element wyrażenia przetwarzany jest jedną pętlą po całym zakresie, a wyniki
+ * pośrednie trzymane są w kolejnych maskach bufora `scratch`.
+ */
+void Predicate::evaluate(const float* const channels[CHANNEL_COUNT], size_t begin, size_t end,
+    std::vector<uint8_t>& mask, std::vector<uint8_t>& scratch) const {
+    size_t count = end > begin ? end - begin : 0;
+    mask.resize(count);
+    if (terms.empty()) {
+        std::fill(mask.begin(), mask.end(), uint8_t(1));
+        return;
+    }
+
+    scratch.resize(depth * count);
+    size_t top = 0;
+    for (const Term& term : terms) {
+        switch (term.kind) {
+        case TERM_RANGE: {
+            uint8_t* out = scratch.data() + top * count;
+            const float* values = channels[term.channel] + begin;
+            float low = term.low;
+            float high = term.high;
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = static_cast<uint8_t>((values[i] >= low) & (values[i] <= high));
+            }
+            ++top;
+            break;
+        }
+        case TERM_AND: {
+            --top;
+            uint8_t* out = scratch.data() + (top - 1) * count;
+            const uint8_t* in = scratch.data() + top * count;
+            for (size_t i = 0; i < count; ++i) {
+                out[i] &= in[i];
+            }
+            break;
+        }
+        case TERM_OR: {
+            --top;
+            uint8_t* out = scratch.data() + (top - 1) * count;
+            const uint8_t* in = scratch.data() + top * count;
+            for (size_t i = 0; i < count; ++i) {
+                out[i] |= in[i];
+            }
+            break;
+        }
+        }
+    }
+
+    std::copy(scratch.begin(), scratch.begin() + count, mask.begin());
+}
@@ -0,0 +1,147 @@
+/**
+ * @file predicate.hpp
+ * @brief Deklaracja klasy `Predicate` opisującej warunki na wartościach kanałów.
+ */
+
+#ifndef PREDICATE_HPP
+#define PREDICATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "aggregate.hpp"
+#include "lineData.hpp"
+
+/**
+ * @class Predicate
+ * @brief Warunek na wartościach kanałów złożony z przedziałów połączonych AND i OR.
+ *
+ * Każde porównanie zamieniane jest na przedział domknięty [low, high] jednego kanału, a całe
+ * wyrażenie zapisywane jest w postaci odwrotnej notacji polskiej. Dzięki temu warunek można
+ * sprawdzać kolumnami: każdy przedział to jedna prosta pętla po kolumnie kanału, a AND i OR
+ * łączą maski bajtowe, co kompilator zamienia na instrukcje wektorowe.
+ *
+ * Na podstawie minimów i maksimów z `Aggregate` warunek potrafi też stwierdzić, że żaden
+ * rekord węzła go nie spełni (`mayMatch`) albo że spełnią go wszystkie (`matchesAll`).
+ *
+ * Przykład: eksport > 2 i import < 0.1
+ * @code
+ * Predicate predicate = Predicate::greater(EKSPORT, 2.0f) && Predicate::less(IMPORT, 0.1f);
+ * @endcode
+ *
+ * Domyślnie utworzony warunek jest spełniony przez każdy rekord.
+ */
+class Predicate {
+public:
+    /**
+     * @brief Tworzy warunek spełniony przez każdy rekord.
+     */
+    Predicate() = default;
+
+    /**
+     * @brief Warunek low <= kanał <= high.
+     */
+    static Predicate between(Channel channel, float low, float high);
+
+    /**
+     * @brief Warunek kanał < value.
+     */
+    static Predicate less(Channel channel, float value);
+
+    /**
+     * @brief Warunek kanał <= value.
+     */
+    static Predicate lessEqual(Channel channel, float value);
+
+    /**
+     * @brief Warunek kanał > value.
+     */
+    static Predicate greater(Channel channel, float value);
+
+    /**
+     * @brief Warunek kanał >= value.
+     */
+    static Predicate greaterEqual(Channel channel, float value);
+
+    /**
+     * @brief Warunek kanał == value.
+     */
+    static Predicate equal(Channel channel, float value);
+
+    /**
+     * @brief Koniunkcja dwóch warunków.
+     */
+    Predicate operator&&(const Predicate& other) const;
+
+    /**
+     * @brief Alternatywa dwóch warunków.
+     */
+    Predicate operator||(const Predicate& other) const;
+
+    /**
+     * @brief Sprawdza, czy warunek jest spełniony dla pojedynczego rekordu.
+     * @param values Wartości kanałów rekordu (indeksowane `Channel`).
+     */
+    bool matches(const float values[CHANNEL_COUNT]) const;
+
+    /**
+     * @brief Sprawdza, czy jakiś rekord o statystykach `aggregate` może spełnić warunek.
+     * @return `false`, jeśli minima i maksima wykluczają dopasowanie.
+     */
+    bool mayMatch(const Aggregate& aggregate) const;
+
+    /**
+     * @brief Sprawdza, czy wszystkie rekordy o statystykach `aggregate` spełniają warunek.
+     */
+    bool matchesAll(const Aggregate& aggregate) const;
+
+    /**
+     * @brief Sprawdza warunek dla zakresu rekordów zapisanych kolumnowo.
+     * @param channels Kolumny wartości kanałów.
+     * @param begin Indeks pierwszego rekordu.
+     * @param end Indeks za ostatnim rekordem.
+     * @param mask Wynik: 1 dla rekordów spełniających warunek, 0 dla pozostałych (`end - begin` elementów).
+     * @param scratch Bufor roboczy, który warto używać ponownie pomiędzy wywołaniami.
+     */
+    void evaluate(const float* const channels[CHANNEL_COUNT], size_t begin, size_t end,
+        std::vector<uint8_t>& mask, std::vector<uint8_t>& scratch) const;
+
+private:
+    /**
+     * @enum TermKind
+     * @brief Rodzaj elementu wyrażenia.
+     */
+    enum TermKind : uint8_t {
+        TERM_RANGE, ///< Przedział wartości kanału
+        TERM_AND,   ///< Koniunkcja dwóch ostatnich wyników
+        TERM_OR     ///< Alternatywa dwóch ostatnich wyników
+    };
+
+    /**
+     * @struct Term
+     * @brief Element wyrażenia w odwrotnej notacji polskiej.
+     */
+    struct Term {
+        TermKind kind; /**< Rodzaj elementu. */
+        Channel channel; /**< Kanał (dla `TERM_RANGE`). */
+        float low; /**< Dolna granica przedziału (dla `TERM_RANGE`). */
+        float high; /**< Górna granica przedziału (dla `TERM_RANGE`). */
+    };
+
+    /**
+     * @brief Łączy dwa warunki operatorem `kind`.
+     */
+    static Predicate combine(const Predicate& left, const Predicate& right, TermKind kind);
+
+    /**
+     * @brief Ocenia wyrażenie na stosie wartości logicznych wyliczanych funkcją `evaluateRange`.
+     */
+    template <typename RangeFn>
+    bool evaluateTerms(RangeFn&& evaluateRange) const;
+
+    std::vector<Term> terms; /**< Wyrażenie w odwrotnej notacji polskiej. */
+    size_t depth = 0; /**< Maksymalna głębokość stosu przy ocenie wyrażenia. */
+};
+
+#endif
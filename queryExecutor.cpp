@@ -0,0 +1,399 @@
+/**
+ * @file queryExecutor.cpp
+ * @brief Implementacja klasy `QueryExecutor`.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "queryExecutor.hpp"
+
+/**
+ * @brief Zapisuje liczbę w najkrótszej postaci pozwalającej odtworzyć wartość `float`.
+ */
+static void writeNumber(std::ostream& out, double value) {
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    out.write(buffer, length);
+}
+
+/**
+ * @brief Zapisuje tekst jako łańcuch JSON (w cudzysłowach, ze znakami specjalnymi poprzedzonymi `\`).
+ */
+static void writeJsonString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned char>(c));
+            out << buffer;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+/**
+ * @brief Odczytuje liczbę zmiennoprzecinkową z całego tekstu.
+ * @throws std::invalid_argument Jeśli tekst nie jest liczbą.
+ */
+static float parseNumber(const std::string& text) {
+    char* end = nullptr;
+    float value = std::strtof(text.c_str(), &end);
+    if (text.empty() || *end != '\0') {
+        throw std::invalid_argument("Niepoprawna liczba: " + text);
+    }
+    return value;
+}
+
+/**
+ * @brief Dzieli tekst na części rozdzielone przecinkami.
+ */
+static std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::istringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+/**
+ * @brief Tworzy wykonawcę zapytań na drzewie danych.
+ */
+QueryExecutor::QueryExecutor(const TreeData& treeData, OutputFormat format)
+    : treeData(&treeData), snapshotView(nullptr), format(format) {}
+
+/**
+ * @brief Tworzy wykonawcę zapytań na migawce odwzorowanej w pamięci.
+ */
+QueryExecutor::QueryExecutor(const SnapshotView& snapshotView, OutputFormat format)
+    : treeData(nullptr), snapshotView(&snapshotView), format(format) {}
+
+/**
+ * @brief Zapisuje nagłówek wyników (tylko dla CSV).
+ */
+void QueryExecutor::writeHeader(std::ostream& out) const {
+    if (format == FORMAT_CSV) {
+        out << "query,command,date";
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            out << ',' << channelName(static_cast<Channel>(channel));
+        }
+        out << '\n';
+    }
+}
+
+/**
+ * @brief Parsuje treść zapytania.
+ */
+bool QueryExecutor::parse(const std::string& line, Query& query) {
+    std::istringstream stream(line);
+    std::vector<std::string> tokens;
+    std::string token;
+    while (stream >> token) {
+        tokens.push_back(token);
+    }
+    if (tokens.empty() || tokens[0][0] == '#') {
+        return false;
+    }
+
+    query.command = tokens[0];
+    size_t dateCount;
+    size_t extraCount = 0;
+    if (query.command == "range" || query.command == "sum" || query.command == "avg") {
+        dateCount = 2;
+    } else if (query.command == "compare") {
+        dateCount = 4;
+    } else if (query.command == "search") {
+        dateCount = 2;
+        extraCount = 3;
+    } else if (query.command == "group") {
+        dateCount = 2;
+        // Po okresie mogą wystąpić jeszcze listy kanałów i funkcji
+        extraCount = tokens.size() >= 6 && tokens.size() <= 8 ? tokens.size() - 5 : 1;
+    } else {
+        throw std::invalid_argument("Nieznane polecenie: " + query.command);
+    }
+
+    if (tokens.size() != 1 + dateCount * 2 + extraCount) {
+        throw std::invalid_argument("Niepoprawna liczba argumentów polecenia " + query.command);
+    }
+
+    for (size_t i = 0; i < dateCount; ++i) {
+        query.dates[i] = tokens[1 + i * 2] + " " + tokens[2 + i * 2];
+        int64_t timestamp;
+        if (!parseTimestamp(query.dates[i], timestamp)) {
+            throw std::invalid_argument("Niepoprawna data: " + query.dates[i]);
+        }
+    }
+
+    if (query.command == "group") {
+        size_t position = 1 + dateCount * 2;
+        if (!parseBucketSize(tokens[position], query.groupBy.bucket)) {
+            throw std::invalid_argument("Nieznany okres: " + tokens[position]);
+        }
+        if (extraCount > 1) {
+            for (const std::string& name : splitList(tokens[position + 1])) {
+                Channel channel;
+                if (!parseChannel(name, channel)) {
+                    throw std::invalid_argument("Nieznany kanał: " + name);
+                }
+                query.groupBy.channels.push_back(channel);
+            }
+        }
+        if (extraCount > 2) {
+            for (const std::string& name : splitList(tokens[position + 2])) {
+                AggregateFunction function;
+                if (!parseAggregateFunction(name, function)) {
+                    throw std::invalid_argument("Nieznana funkcja: " + name);
+                }
+                query.groupBy.functions.push_back(function);
+            }
+        }
+        if (query.groupBy.channels.empty()) {
+            for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                query.groupBy.channels.push_back(static_cast<Channel>(channel));
+            }
+        }
+        if (query.groupBy.functions.empty()) {
+            query.groupBy.functions.push_back(FUNCTION_SUM);
+        }
+    } else if (extraCount > 0) {
+        size_t position = 1 + dateCount * 2;
+        if (!parseChannel(tokens[position], query.channel)) {
+            throw std::invalid_argument("Nieznany kanał: " + tokens[position]);
+        }
+        query.value = parseNumber(tokens[position + 1]);
+        query.tolerance = parseNumber(tokens[position + 2]);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Wykonuje jedno zapytanie i zapisuje jego wynik.
+ */
+void QueryExecutor::execute(const std::string& line, std::ostream& out) {
+    Query query;
+    if (!parse(line, query)) {
+        return;
+    }
+
+    ++queryCount;
+    if (treeData) {
+        executeOn(*treeData, query, out);
+    } else {
+        executeOn(*snapshotView, query, out);
+    }
+}
+
+/**
+ * @brief Wykonuje jedno zapytanie, zapisując ewentualny błąd w wynikach.
+ */
+bool QueryExecutor::respond(const std::string& line, std::ostream& out) {
+    try {
+        execute(line, out);
+    } catch (const std::invalid_argument& e) {
+        ++queryCount;
+        writeError(out, e.what());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Przełącza wykonawcę na inne drzewo.
+ */
+void QueryExecutor::setSource(const TreeData& treeData) {
+    this->treeData = &treeData;
+    snapshotView = nullptr;
+}
+
+/**
+ * @brief Zapisuje komunikat o błędzie bieżącego zapytania.
+ */
+void QueryExecutor::writeError(std::ostream& out, const std::string& message) const {
+    if (format == FORMAT_JSON) {
+        out << "{\"query\":" << queryCount << ",\"error\":";
+        writeJsonString(out, message);
+        out << "}\n";
+    } else {
+        out << queryCount << ",error,\"";
+        for (char c : message) {
+            if (c == '"') {
+                out << '"';
+            }
+            out << c;
+        }
+        out << "\"\n";
+    }
+}
+
+/**
+ * @brief Wykonuje wszystkie zapytania ze strumienia wejściowego.
+ */
+size_t QueryExecutor::executeScript(std::istream& in, std::ostream& out, std::ostream& errors) {
+    size_t failures = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        try {
+            execute(line, out);
+        } catch (const std::invalid_argument& e) {
+            ++queryCount;
+            ++failures;
+            errors << "Zapytanie " << queryCount << ": " << e.what() << std::endl;
+            if (format == FORMAT_JSON) {
+                writeError(out, e.what());
+            }
+        }
+    }
+    return failures;
+}
+
+/**
+ * @brief Wykonuje sparsowane zapytanie na wskazanym źródle danych.
+ */
+template <typename Source>
+void QueryExecutor::executeOn(const Source& source, const Query& query, std::ostream& out) const {
+    if (query.command == "range" || query.command == "search") {
+        bool first = true;
+        auto writeRecord = [&](const RecordView& record) {
+            char date[DATE_BUFFER_SIZE];
+            size_t length = formatTimestamp(record.getTimestamp(), date, sizeof(date));
+
+            if (format == FORMAT_CSV) {
+                out << queryCount << ',' << query.command << ',';
+                out.write(date, static_cast<std::streamsize>(length));
+                for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                    out << ',';
+                    writeNumber(out, record.getValue(static_cast<Channel>(channel)));
+                }
+                out << '\n';
+            } else {
+                out << (first ? "" : ",") << "{\"date\":\"";
+                out.write(date, static_cast<std::streamsize>(length));
+                out << '"';
+                for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                    out << ",\"" << channelName(static_cast<Channel>(channel)) << "\":";
+                    writeNumber(out, record.getValue(static_cast<Channel>(channel)));
+                }
+                out << '}';
+            }
+            first = false;
+        };
+
+        if (format == FORMAT_JSON) {
+            out << "{\"query\":" << queryCount << ",\"command\":\"" << query.command << "\",\"records\":[";
+        }
+        if (query.command == "range") {
+            source.forEachBetweenDates(query.dates[0], query.dates[1], writeRecord);
+        } else {
+            source.forEachWithTolerance(query.dates[0], query.dates[1], query.value, query.tolerance,
+                query.channel, writeRecord);
+        }
+        if (format == FORMAT_JSON) {
+            out << "]}\n";
+        }
+        return;
+    }
+
+    if (query.command == "group") {
+        writeGroups(out, query.groupBy, source.groupBetweenDates(query.dates[0], query.dates[1], query.groupBy));
+        return;
+    }
+
+    double values[CHANNEL_COUNT];
+    Aggregate aggregate = source.aggregateBetweenDates(query.dates[0], query.dates[1]);
+    if (query.command == "sum") {
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            values[channel] = aggregate.sum[channel];
+        }
+    } else if (query.command == "avg") {
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            values[channel] = aggregate.average(static_cast<Channel>(channel));
+        }
+    } else {
+        Aggregate second = source.aggregateBetweenDates(query.dates[2], query.dates[3]);
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            values[channel] = second.sum[channel] - aggregate.sum[channel];
+        }
+    }
+    writeValues(out, query.command, values);
+}
+
+/**
+ * @brief Zapisuje wynik w postaci wartości pięciu kanałów.
+ */
+void QueryExecutor::writeValues(std::ostream& out, const std::string& command, const double values[CHANNEL_COUNT]) const {
+    if (format == FORMAT_CSV) {
+        out << queryCount << ',' << command << ',';
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            out << ',';
+            writeNumber(out, values[channel]);
+        }
+        out << '\n';
+    } else {
+        out << "{\"query\":" << queryCount << ",\"command\":\"" << command << "\",\"values\":{";
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            out << (channel == 0 ? "\"" : ",\"") << channelName(static_cast<Channel>(channel)) << "\":";
+            writeNumber(out, values[channel]);
+        }
+        out << "}}\n";
+    }
+}
+
+/**
+ * @brief Zapisuje wyniki grupowania.
+ */
+void QueryExecutor::writeGroups(std::ostream& out, const GroupBy& groupBy, const std::vector<GroupRow>& rows) const {
+    size_t functionCount = groupBy.functions.size();
+    char date[DATE_BUFFER_SIZE];
+
+    if (format == FORMAT_CSV) {
+        for (const GroupRow& row : rows) {
+            size_t length = formatTimestamp(row.timestamp, date, sizeof(date));
+            for (size_t function = 0; function < functionCount; ++function) {
+                out << queryCount << ",group:" << aggregateFunctionName(groupBy.functions[function]) << ',';
+                out.write(date, static_cast<std::streamsize>(length));
+                for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                    out << ',';
+                    for (size_t selected = 0; selected < groupBy.channels.size(); ++selected) {
+                        if (groupBy.channels[selected] == channel) {
+                            writeNumber(out, row.values[selected * functionCount + function]);
+                            break;
+                        }
+                    }
+                }
+                out << '\n';
+            }
+        }
+        return;
+    }
+
+    out << "{\"query\":" << queryCount << ",\"command\":\"group\",\"bucket\":\""
+        << bucketSizeName(groupBy.bucket) << "\",\"groups\":[";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const GroupRow& row = rows[i];
+        size_t length = formatTimestamp(row.timestamp, date, sizeof(date));
+        out << (i == 0 ? "" : ",") << "{\"date\":\"";
+        out.write(date, static_cast<std::streamsize>(length));
+        out << "\",\"count\":" << row.count;
+        for (size_t function = 0; function < functionCount; ++function) {
+            out << ",\"" << aggregateFunctionName(groupBy.functions[function]) << "\":{";
+            for (size_t selected = 0; selected < groupBy.channels.size(); ++selected) {
+                out << (selected == 0 ? "\"" : ",\"") << channelName(groupBy.channels[selected]) << "\":";
+                writeNumber(out, row.values[selected * functionCount + function]);
+            }
+            out << '}';
+        }
+        out << '}';
+    }
+    out << "]}\n";
+}
@@ -0,0 +1,166 @@
+/**
+ * @file queryExecutor.hpp
+ * @brief Deklaracja klasy `QueryExecutor` wykonującej zapytania tekstowe i zapisującej wyniki w CSV lub JSON.
+ *
+ * ## Składnia zapytań (jedno na wiersz, daty w formacie "dd.mm.yyyy hh:mm"):
+ * - `range <od> <do>` - rekordy z przedziału,
+ * - `sum <od> <do>` - sumy kanałów,
+ * - `avg <od> <do>` - średnie kanałów,
+ * - `compare <od1> <do1> <od2> <do2>` - różnice sum (drugi przedział minus pierwszy),
+ * - `search <od> <do> <kanał> <wartość> <tolerancja>` - rekordy z wartością kanału w tolerancji,
+ * - `group <od> <do> <okres> [kanały] [funkcje]` - wartości kanałów w przedziałach `15min`, `hour`, `day`,
+ *   `week`, `month` lub `year`; kanały i funkcje (`sum`, `avg`, `min`, `max`, `count`) podawane są
+ *   po przecinku, domyślnie wszystkie kanały i `sum`.
+ *
+ * Puste wiersze i wiersze zaczynające się od `#` są pomijane.
+ *
+ * ## Format wyników:
+ * - CSV: nagłówek `query,command,date,autokonsumpcja,eksport,import,pobor,produkcja`, a potem
+ *   po jednym wierszu na rekord lub wynik (dla sum, średnich i porównań kolumna `date` jest pusta).
+ *   Dla `group` wiersz przypada na przedział i funkcję: polecenie ma postać `group:<funkcja>`,
+ *   `date` to początek przedziału, a kolumny niewybranych kanałów są puste.
+ * - JSON: jeden obiekt w wierszu na zapytanie (JSON Lines), z polem `records` lub `values`,
+ *   a dla błędnych zapytań z polem `error`. Wynik `group` ma pole `groups` z obiektami
+ *   `{"date":...,"count":...,"<funkcja>":{"<kanał>":...}}`.
+ */
+
+#ifndef QUERYEXECUTOR_HPP
+#define QUERYEXECUTOR_HPP
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "snapshotView.hpp"
+#include "treeData.hpp"
+
+/**
+ * @enum OutputFormat
+ * @brief Format wyników zapytań.
+ */
+enum OutputFormat {
+    FORMAT_CSV,  ///< Wartości rozdzielone przecinkami
+    FORMAT_JSON  ///< Jeden obiekt JSON w wierszu na zapytanie
+};
+
+/**
+ * @class QueryExecutor
+ * @brief Wykonuje zapytania tekstowe na `TreeData` lub `SnapshotView`.
+ *
+ * Rekordy wynikowe zapisywane są strumieniowo przez `RecordView`, bez budowania list wyników.
+ * Źródło danych musi istnieć przez cały czas życia obiektu.
+ */
+class QueryExecutor {
+public:
+    /**
+     * @brief Tworzy wykonawcę zapytań na drzewie danych.
+     */
+    QueryExecutor(const TreeData& treeData, OutputFormat format);
+
+    /**
+     * @brief Tworzy wykonawcę zapytań na migawce odwzorowanej w pamięci.
+     */
+    QueryExecutor(const SnapshotView& snapshotView, OutputFormat format);
+
+    /**
+     * @brief Zapisuje nagłówek wyników (tylko dla CSV).
+     * @param out Strumień wyjściowy.
+     */
+    void writeHeader(std::ostream& out) const;
+
+    /**
+     * @brief Wykonuje jedno zapytanie i zapisuje jego wynik.
+     *
+     * Puste wiersze i komentarze nie są liczone jako zapytania.
+     *
+     * @param line Treść zapytania.
+     * @param out Strumień wyjściowy.
+     * @throws std::invalid_argument Jeśli zapytanie jest niepoprawne.
+     */
+    void execute(const std::string& line, std::ostream& out);
+
+    /**
+     * @brief Wykonuje jedno zapytanie, zapisując ewentualny błąd w wynikach zamiast zgłaszać wyjątek.
+     *
+     * Błąd zapisywany jest w JSON jako obiekt z polem `error`, a w CSV jako wiersz `<nr>,error,"<komunikat>"`.
+     *
+     * @param line Treść zapytania.
+     * @param out Strumień wyjściowy.
+     * @return `false`, jeśli zapytanie było błędne.
+     */
+    bool respond(const std::string& line, std::ostream& out);
+
+    /**
+     * @brief Przełącza wykonawcę na inne drzewo (np. nowszą wersję z `TreeStore`), zachowując numerację zapytań.
+     * @param treeData Drzewo danych; musi istnieć do następnego przełączenia.
+     */
+    void setSource(const TreeData& treeData);
+
+    /**
+     * @brief Wykonuje wszystkie zapytania ze strumienia wejściowego.
+     *
+     * Błędne zapytania są zgłaszane na `errors` (a w formacie JSON także w wynikach) i pomijane.
+     *
+     * @param in Strumień z zapytaniami.
+     * @param out Strumień wyników.
+     * @param errors Strumień komunikatów o błędach.
+     * @return Liczba błędnych zapytań.
+     */
+    size_t executeScript(std::istream& in, std::ostream& out, std::ostream& errors);
+
+    /**
+     * @brief Zwraca liczbę wykonanych zapytań (także błędnych).
+     */
+    size_t getQueryCount() const { return queryCount; }
+
+private:
+    /**
+     * @struct Query
+     * @brief Sparsowane zapytanie.
+     */
+    struct Query {
+        std::string command; /**< Nazwa polecenia. */
+        std::string dates[4]; /**< Daty graniczne przedziałów. */
+        Channel channel = AUTOKONSUMPCJA; /**< Kanał (dla `search`). */
+        float value = 0.0f; /**< Wyszukiwana wartość (dla `search`). */
+        float tolerance = 0.0f; /**< Tolerancja (dla `search`). */
+        GroupBy groupBy; /**< Przedział, kanały i funkcje (dla `group`). */
+    };
+
+    /**
+     * @brief Parsuje treść zapytania.
+     * @return `false` dla pustych wierszy i komentarzy.
+     * @throws std::invalid_argument Jeśli zapytanie jest niepoprawne.
+     */
+    static bool parse(const std::string& line, Query& query);
+
+    /**
+     * @brief Wykonuje sparsowane zapytanie na wskazanym źródle danych.
+     */
+    template <typename Source>
+    void executeOn(const Source& source, const Query& query, std::ostream& out) const;
+
+    /**
+     * @brief Zapisuje wynik w postaci wartości pięciu kanałów.
+     */
+    void writeValues(std::ostream& out, const std::string& command, const double values[CHANNEL_COUNT]) const;
+
+    /**
+     * @brief Zapisuje komunikat o błędzie bieżącego zapytania.
+     */
+    void writeError(std::ostream& out, const std::string& message) const;
+
+    /**
+     * @brief Zapisuje wyniki grupowania.
+     */
+    void writeGroups(std::ostream& out, const GroupBy& groupBy, const std::vector<GroupRow>& rows) const;
+
+    const TreeData* treeData; /**< Drzewo danych lub `nullptr`. */
+    const SnapshotView* snapshotView; /**< Migawka lub `nullptr`. */
+    OutputFormat format; /**< Format wyników. */
+    size_t queryCount = 0; /**< Liczba wykonanych zapytań. */
+};
+
+#endif
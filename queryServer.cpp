@@ -0,0 +1,339 @@
+/**
+ * @file queryServer.cpp
+ * @brief Implementacja klasy `QueryServer` dla systemów POSIX.
+ */
+
+#include <deque>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "queryServer.hpp"
+#include "threadPool.hpp"
+
+/**
+ * @brief Co ile milisekund wątek przyjmujący połączenia sprawdza prośbę o zatrzymanie.
+ */
+static const int STOP_CHECK_INTERVAL = 200;
+
+/**
+ * @brief Największa długość niezakończonego wiersza zapytania; dłuższy wiersz zamyka połączenie.
+ */
+static const size_t MAX_REQUEST_LENGTH = 64 * 1024;
+
+/**
+ * @brief Tworzy serwer odpowiadający na podstawie bieżącej wersji drzewa.
+ */
+QueryServer::QueryServer(const TreeStore& store, OutputFormat format, size_t threadCount)
+    : store(&store), snapshotView(nullptr), format(format), threadCount(threadCount) {}
+
+/**
+ * @brief Tworzy serwer odpowiadający na podstawie migawki.
+ */
+QueryServer::QueryServer(const SnapshotView& snapshotView, OutputFormat format, size_t threadCount)
+    : store(nullptr), snapshotView(&snapshotView), format(format), threadCount(threadCount) {}
+
+#if defined(_WIN32) || defined(_WIN64)
+
+QueryServer::~QueryServer() {}
+
+bool QueryServer::listenUnix(const std::string&) {
+    return false;
+}
+
+bool QueryServer::listenTcp(uint16_t) {
+    return false;
+}
+
+void QueryServer::run() {}
+
+void QueryServer::answer(Connection&, const std::string&) {}
+
+#else
+
+/**
+ * @brief Wysyła cały bufor, ponawiając częściowe zapisy.
+ * @return `false`, jeśli połączenie zostało zamknięte.
+ */
+static bool sendAll(int descriptor, const std::string& data) {
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t written = ::send(descriptor, data.data() + sent, data.size() - sent, flags);
+        if (written <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * @brief Zamyka gniazdo nasłuchujące (i usuwa plik gniazda Unix).
+ */
+QueryServer::~QueryServer() {
+    if (listenDescriptor >= 0) {
+        ::close(listenDescriptor);
+    }
+    if (!socketPath.empty()) {
+        ::unlink(socketPath.c_str());
+    }
+}
+
+/**
+ * @brief Rozpoczyna nasłuchiwanie na gnieździe Unix.
+ */
+bool QueryServer::listenUnix(const std::string& path) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (listenDescriptor >= 0 || path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    path.copy(address.sun_path, path.size());
+
+    struct stat status;
+    if (::stat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)) {
+        ::unlink(path.c_str());
+    }
+
+    int descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (descriptor < 0) {
+        return false;
+    }
+    if (::bind(descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(descriptor, SOMAXCONN) != 0) {
+        ::close(descriptor);
+        return false;
+    }
+
+    listenDescriptor = descriptor;
+    socketPath = path;
+    return true;
+}
+
+/**
+ * @brief Rozpoczyna nasłuchiwanie na porcie TCP adresu 127.0.0.1.
+ */
+bool QueryServer::listenTcp(uint16_t port) {
+    if (listenDescriptor >= 0) {
+        return false;
+    }
+    int descriptor = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (descriptor < 0) {
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    socklen_t length = sizeof(address);
+    if (::bind(descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(descriptor, SOMAXCONN) != 0
+        || ::getsockname(descriptor, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        ::close(descriptor);
+        return false;
+    }
+
+    listenDescriptor = descriptor;
+    this->port = ntohs(address.sin_port);
+    return true;
+}
+
+/**
+ * @brief Deskryptor zamykany przy zniszczeniu obiektu.
+ */
+struct UniqueDescriptor {
+    int value;
+
+    explicit UniqueDescriptor(int value = -1) : value(value) {}
+    ~UniqueDescriptor() {
+        if (value >= 0) {
+            ::close(value);
+        }
+    }
+
+    UniqueDescriptor(const UniqueDescriptor&) = delete;
+    UniqueDescriptor& operator=(const UniqueDescriptor&) = delete;
+};
+
+/**
+ * @struct QueryServer::Connection
+ * @brief Stan jednego połączenia.
+ *
+ * Bufor i kolejkę zapytań zmienia tylko wątek `run`, i to wyłącznie wtedy, gdy żadne zapytanie
+ * połączenia nie jest wykonywane (`busy`); wykonawcy używa tylko zadanie puli.
+ */
+struct QueryServer::Connection {
+    UniqueDescriptor descriptor; /**< Gniazdo połączenia. */
+    std::string pending; /**< Odebrany, niezakończony wiersz. */
+    std::deque<std::string> requests; /**< Odebrane zapytania czekające na wykonanie. */
+    std::shared_ptr<const TreeData> version; /**< Wersja drzewa używana przez wykonawcę. */
+    std::unique_ptr<QueryExecutor> executor; /**< Wykonawca zapytań (numeruje zapytania połączenia). */
+    bool finished = false; /**< Czy klient zakończył wysyłanie. */
+    std::atomic<bool> busy{ false }; /**< Czy zapytanie jest zlecone puli. */
+    std::atomic<bool> failed{ false }; /**< Czy połączenie należy zamknąć bez dalszych odpowiedzi. */
+
+    explicit Connection(int descriptor) : descriptor(descriptor) {}
+};
+
+/**
+ * @brief Dzieli odebrane dane na kompletne wiersze zapytań.
+ */
+static void splitRequests(std::string& pending, std::deque<std::string>& requests) {
+    size_t lineStart = 0;
+    size_t lineEnd;
+    while ((lineEnd = pending.find('\n', lineStart)) != std::string::npos) {
+        std::string line = pending.substr(lineStart, lineEnd - lineStart);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        requests.push_back(std::move(line));
+        lineStart = lineEnd + 1;
+    }
+    pending.erase(0, lineStart);
+}
+
+/**
+ * @brief Przyjmuje połączenia i zleca ich zapytania do czasu wywołania `stop`.
+ */
+void QueryServer::run() {
+    if (listenDescriptor < 0) {
+        return;
+    }
+
+    // Zadanie puli po wykonaniu zapytania budzi wątek przyjmujący przez to łącze
+    int wakeEnds[2];
+    if (::pipe(wakeEnds) != 0) {
+        return;
+    }
+    UniqueDescriptor wakeRead(wakeEnds[0]);
+    UniqueDescriptor wakeWrite(wakeEnds[1]);
+    ::fcntl(wakeRead.value, F_SETFL, O_NONBLOCK);
+    ::fcntl(wakeWrite.value, F_SETFL, O_NONBLOCK);
+
+    // Połączenia są zamykane dopiero po zniszczeniu puli, czyli po wykonaniu zleconych zapytań
+    std::vector<std::unique_ptr<Connection>> connections;
+    ThreadPool pool(threadCount);
+    std::vector<pollfd> waiting;
+    std::vector<Connection*> polled;
+    char buffer[4096];
+    while (!stopping) {
+        // Zlecenie kolejnych zapytań i zamknięcie zakończonych połączeń
+        for (size_t i = 0; i < connections.size();) {
+            Connection* connection = connections[i].get();
+            if (connection->busy) {
+                ++i;
+                continue;
+            }
+            if (connection->failed || (connection->finished && connection->requests.empty())) {
+                connections[i] = std::move(connections.back());
+                connections.pop_back();
+                continue;
+            }
+            if (!connection->requests.empty()) {
+                std::string line = std::move(connection->requests.front());
+                connection->requests.pop_front();
+                connection->busy = true;
+                int wake = wakeWrite.value;
+                pool.submit([this, connection, line, wake]() {
+                    answer(*connection, line);
+                    connection->busy = false;
+                    char signal = 0;
+                    ssize_t written = ::write(wake, &signal, 1);
+                    (void)written;
+                });
+            }
+            ++i;
+        }
+
+        waiting.clear();
+        polled.clear();
+        waiting.push_back({ listenDescriptor, POLLIN, 0 });
+        waiting.push_back({ wakeRead.value, POLLIN, 0 });
+        for (const auto& connection : connections) {
+            if (!connection->busy && !connection->finished && connection->requests.empty()) {
+                waiting.push_back({ connection->descriptor.value, POLLIN, 0 });
+                polled.push_back(connection.get());
+            }
+        }
+        if (::poll(waiting.data(), waiting.size(), STOP_CHECK_INTERVAL) <= 0) {
+            continue;
+        }
+
+        if (waiting[1].revents != 0) {
+            while (::read(wakeRead.value, buffer, sizeof(buffer)) > 0) {
+            }
+        }
+        for (size_t i = 0; i < polled.size(); ++i) {
+            if (waiting[i + 2].revents == 0) {
+                continue;
+            }
+            Connection* connection = polled[i];
+            ssize_t received = ::recv(connection->descriptor.value, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                connection->finished = true;
+                continue;
+            }
+            connection->pending.append(buffer, static_cast<size_t>(received));
+            splitRequests(connection->pending, connection->requests);
+            if (connection->pending.size() > MAX_REQUEST_LENGTH) {
+                connection->failed = true;
+            }
+        }
+        if (waiting[0].revents != 0) {
+            int descriptor = ::accept(listenDescriptor, nullptr, nullptr);
+            if (descriptor >= 0) {
+                std::unique_ptr<Connection> connection(new Connection(descriptor));
+                if (store) {
+                    connection->version = store->snapshot();
+                    connection->executor.reset(new QueryExecutor(*connection->version, format));
+                } else {
+                    connection->executor.reset(new QueryExecutor(*snapshotView, format));
+                }
+                connections.push_back(std::move(connection));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Wykonuje jedno zapytanie połączenia i odsyła wynik.
+ */
+void QueryServer::answer(Connection& connection, const std::string& line) {
+    try {
+        // Każde zapytanie widzi najnowszą opublikowaną wersję drzewa
+        if (store) {
+            connection.version = store->snapshot();
+            connection.executor->setSource(*connection.version);
+        }
+        std::ostringstream out;
+        connection.executor->respond(line, out);
+        out << '\n';
+        if (!sendAll(connection.descriptor.value, out.str())) {
+            connection.failed = true;
+        }
+    } catch (const std::exception&) {
+        // Np. uszkodzony blok migawki lub brak pamięci; połączenie zostanie zamknięte
+        connection.failed = true;
+    }
+}
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * @file queryServer.hpp
+ * @brief Deklaracja klasy `QueryServer` odpowiadającej na zapytania przez gniazdo lokalne lub TCP.
+ *
+ * ## Protokół:
+ * Klient wysyła zapytania w składni `QueryExecutor` (jedno na wiersz, np. `sum 01.01.2023 00:00 31.12.2023 23:59`).
+ * Na każdy wiersz serwer odsyła wynik w wybranym formacie (CSV bez nagłówka lub JSON Lines) zakończony
+ * pustym wierszem, więc klient może wysyłać kolejne zapytania tym samym połączeniem. Błędne zapytanie
+ * nie zamyka połączenia, tylko daje wynik z błędem (zob. `QueryExecutor::respond`).
+ */
+
+#ifndef QUERYSERVER_HPP
+#define QUERYSERVER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "queryExecutor.hpp"
+#include "snapshotView.hpp"
+#include "treeStore.hpp"
+
+/**
+ * @class QueryServer
+ * @brief Serwer zapytań nasłuchujący na gnieździe Unix lub porcie TCP interfejsu lokalnego.
+ *
+ * Wątek `run` czeka (`poll`) jednocześnie na nowe połączenia i na dane wszystkich otwartych połączeń,
+ * a każdy odebrany kompletny wiersz zleca stałej puli wątków (`ThreadPool`). Bezczynne połączenia
+ * nie zajmują więc wątków puli. Zapytania jednego połączenia wykonywane są po kolei, więc odpowiedzi
+ * przychodzą w kolejności zapytań. Każde zapytanie wykonywane jest na wersji drzewa aktualnej
+ * w chwili jego wykonania (`TreeStore::snapshot`), więc dane mogą być w tym czasie dopisywane.
+ *
+ * Gniazda dostępne są tylko w systemach POSIX; pod Windows `listenUnix` i `listenTcp` zwracają `false`.
+ */
+class QueryServer {
+public:
+    /**
+     * @brief Tworzy serwer odpowiadający na podstawie bieżącej wersji drzewa.
+     * @param store Magazyn wersji drzewa; musi istnieć przez cały czas życia serwera.
+     * @param format Format wyników.
+     * @param threadCount Liczba wątków wykonujących zapytania (0 oznacza liczbę rdzeni).
+     */
+    QueryServer(const TreeStore& store, OutputFormat format, size_t threadCount);
+
+    /**
+     * @brief Tworzy serwer odpowiadający na podstawie migawki odwzorowanej w pamięci.
+     * @param snapshotView Migawka; musi istnieć przez cały czas życia serwera.
+     * @param format Format wyników.
+     * @param threadCount Liczba wątków wykonujących zapytania (0 oznacza liczbę rdzeni).
+     */
+    QueryServer(const SnapshotView& snapshotView, OutputFormat format, size_t threadCount);
+
+    /**
+     * @brief Zamyka gniazdo nasłuchujące (i usuwa plik gniazda Unix).
+     */
+    ~QueryServer();
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    /**
+     * @brief Rozpoczyna nasłuchiwanie na gnieździe Unix.
+     *
+     * Pozostawione przez poprzednie uruchomienie gniazdo o tej ścieżce jest usuwane; inny plik nie.
+     *
+     * @param path Ścieżka gniazda.
+     * @return `false`, jeśli gniazda nie udało się utworzyć.
+     */
+    bool listenUnix(const std::string& path);
+
+    /**
+     * @brief Rozpoczyna nasłuchiwanie na porcie TCP adresu 127.0.0.1.
+     * @param port Numer portu (0 oznacza port wybrany przez system, zob. `getPort`).
+     * @return `false`, jeśli gniazda nie udało się utworzyć.
+     */
+    bool listenTcp(uint16_t port);
+
+    /**
+     * @brief Przyjmuje i obsługuje połączenia do czasu wywołania `stop`.
+     *
+     * Po zatrzymaniu czeka na wykonanie zleconych już zapytań i zamyka otwarte połączenia.
+     */
+    void run();
+
+    /**
+     * @brief Prosi o zatrzymanie serwera; można wywołać z innego wątku lub z obsługi sygnału.
+     */
+    void stop() { stopping = true; }
+
+    /**
+     * @brief Zwraca `true`, jeśli poproszono o zatrzymanie serwera.
+     */
+    bool isStopping() const { return stopping; }
+
+    /**
+     * @brief Zwraca port TCP, na którym nasłuchuje serwer (0 dla gniazda Unix).
+     */
+    uint16_t getPort() const { return port; }
+
+private:
+    struct Connection;
+
+    /**
+     * @brief Wykonuje jedno zapytanie połączenia i odsyła wynik.
+     *
+     * Nie zgłasza wyjątków; jeśli wysłanie wyniku lub wykonanie zapytania się nie powiodło,
+     * oznacza połączenie do zamknięcia.
+     *
+     * @param connection Połączenie, z którego odebrano zapytanie.
+     * @param line Treść zapytania.
+     */
+    void answer(Connection& connection, const std::string& line);
+
+    const TreeStore* store; /**< Magazyn wersji drzewa lub `nullptr`. */
+    const SnapshotView* snapshotView; /**< Migawka lub `nullptr`. */
+    OutputFormat format; /**< Format wyników. */
+    size_t threadCount; /**< Liczba wątków wykonujących zapytania. */
+    int listenDescriptor = -1; /**< Deskryptor gniazda nasłuchującego lub -1. */
+    std::string socketPath; /**< Ścieżka gniazda Unix (pusta dla TCP). */
+    uint16_t port = 0; /**< Port TCP. */
+    std::atomic<bool> stopping{ false }; /**< Czy poproszono o zatrzymanie. */
+};
+
+#endif
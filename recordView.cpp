@@ -0,0 +1,33 @@
+/**
+ * @file recordView.cpp
+ * @brief Implementacja klasy `RecordView`.
+ */
+
+#include "dateTime.hpp"
+#include "recordView.hpp"
+
+/**
+ * @brief Zwraca datę rekordu w formacie "dd.mm.yyyy hh:mm".
+ */
+std::string RecordView::getDate() const {
+    return formatTimestamp(timestamp);
+}
+
+/**
+ * @brief Tworzy niezależną kopię rekordu.
+ */
+LineData RecordView::toLineData() const {
+    return LineData(timestamp, getAutokonsumpcja(), getEksport(), getImport(), getPobor(), getProdukcja());
+}
+
+/**
+ * @brief Wypisuje rekord w tym samym formacie co `LineData::print`.
+ */
+void RecordView::print(std::ostream& out) const {
+    char date[DATE_BUFFER_SIZE];
+    size_t length = formatTimestamp(timestamp, date, sizeof(date));
+
+    out.write(date, static_cast<std::streamsize>(length));
+    out << " " << getAutokonsumpcja() << " " << getEksport() << " "
+        << getImport() << " " << getPobor() << " " << getProdukcja() << '\n';
+}
@@ -0,0 +1,73 @@
+/**
+ * @file recordView.hpp
+ * @brief Definicja klasy `RecordView` - lekkiego widoku na rekord przechowywany kolumnowo.
+ */
+
+#ifndef RECORDVIEW_HPP
+#define RECORDVIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "lineData.hpp"
+
+/**
+ * @class RecordView
+ * @brief Widok na jeden rekord w kolumnach `TreeData` lub `SnapshotView`.
+ *
+ * Widok nie kopiuje wartości ani nie alokuje pamięci - odczytuje je bezpośrednio z kolumn.
+ * Jest ważny tylko w trakcie wywołania funkcji odwiedzającej, która go otrzymała;
+ * aby zachować rekord, należy go skopiować przez `toLineData`.
+ */
+class RecordView {
+public:
+    /**
+     * @brief Tworzy widok na rekord.
+     * @param timestamp Znacznik czasu rekordu.
+     * @param channels Kolumny wartości kanałów (indeksowane `Channel`).
+     * @param index Pozycja rekordu w kolumnach.
+     */
+    RecordView(int64_t timestamp, const float* const* channels, size_t index)
+        : timestamp(timestamp), channels(channels), index(index) {}
+
+    /**
+     * @brief Zwraca znacznik czasu rekordu.
+     */
+    int64_t getTimestamp() const { return timestamp; }
+
+    /**
+     * @brief Zwraca wartość wybranego kanału.
+     */
+    float getValue(Channel channel) const { return channels[channel][index]; }
+
+    float getAutokonsumpcja() const { return getValue(AUTOKONSUMPCJA); } ///< Zwraca autokonsumpcję.
+    float getEksport() const { return getValue(EKSPORT); }               ///< Zwraca eksport.
+    float getImport() const { return getValue(IMPORT); }                 ///< Zwraca import.
+    float getPobor() const { return getValue(POBOR); }                   ///< Zwraca pobór.
+    float getProdukcja() const { return getValue(PRODUKCJA); }           ///< Zwraca produkcję.
+
+    /**
+     * @brief Zwraca datę rekordu w formacie "dd.mm.yyyy hh:mm".
+     */
+    std::string getDate() const;
+
+    /**
+     * @brief Tworzy niezależną kopię rekordu.
+     */
+    LineData toLineData() const;
+
+    /**
+     * @brief Wypisuje rekord w tym samym formacie co `LineData::print`, bez alokacji.
+     * @param out Strumień wyjściowy.
+     */
+    void print(std::ostream& out) const;
+
+private:
+    int64_t timestamp; /**< Znacznik czasu rekordu. */
+    const float* const* channels; /**< Kolumny wartości kanałów. */
+    size_t index; /**< Pozycja rekordu w kolumnach. */
+};
+
+#endif
@@ -0,0 +1,276 @@
+/**
+ * @file snapshot.cpp
+ * @brief Implementacja zapisu i odczytu migawek danych w formacie kolumnowym.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "snapshot.hpp"
+#include "timeSeriesCodec.hpp"
+
+const char Snapshot::MAGIC[8] = { 'P', 'R', 'J', '6', 'S', 'N', 'A', 'P' };
+
+/**
+ * @struct CrcTable
+ * @brief Tablica pomocnicza algorytmu CRC32.
+ */
+struct CrcTable {
+    uint32_t values[256];
+
+    CrcTable() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            values[i] = value;
+        }
+    }
+};
+
+/**
+ * @brief Oblicza sumę kontrolną CRC32 (IEEE 802.3).
+ */
+uint32_t Snapshot::checksum(const void* data, size_t size) {
+    static const CrcTable table;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table.values[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief Sprawdza poprawność nagłówka pliku.
+ */
+void Snapshot::validateHeader(const FileHeader& header) {
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Plik nie jest migawką danych");
+    }
+    if (header.version != VERSION) {
+        throw std::runtime_error("Nieobsługiwana wersja migawki: " + std::to_string(header.version));
+    }
+    if (checksum(&header, offsetof(FileHeader, headerChecksum)) != header.headerChecksum) {
+        throw std::runtime_error("Niepoprawna suma kontrolna nagłówka migawki");
+    }
+}
+
+/**
+ * @brief Sprawdza, czy nagłówek bloku pasuje do kolumny i liczby rekordów segmentu.
+ */
+void Snapshot::validateBlock(const BlockHeader& header, uint32_t column, size_t count) {
+    size_t valueSize = column == 0 ? sizeof(int64_t) : sizeof(float);
+    uint32_t compressedEncoding = column == 0 ? ENCODING_DELTA_OF_DELTA : ENCODING_XOR;
+
+    bool valid;
+    if (count == 0 || count > SEGMENT_SIZE) {
+        // Ograniczenie liczby rekordów wyklucza przepełnienie poniższych iloczynów
+        valid = false;
+    } else if (header.encoding == ENCODING_RAW) {
+        valid = header.byteSize == count * valueSize;
+    } else {
+        // Każdy zakodowany rekord zajmuje co najmniej jeden bit i nie więcej niż najdłuższy kod.
+        size_t maxSize = column == 0 ? TimeSeriesCodec::maxTimestampsSize(count) : TimeSeriesCodec::maxFloatsSize(count);
+        valid = header.encoding == compressedEncoding && header.byteSize <= maxSize && count <= header.byteSize * 8;
+    }
+
+    if (header.column != column || !valid) {
+        throw std::runtime_error("Niepoprawny nagłówek bloku migawki");
+    }
+}
+
+/**
+ * @brief Dekoduje zawartość bloku do tablicy wartości kolumny.
+ */
+void Snapshot::decodeBlock(const BlockHeader& header, const void* payload, void* values, size_t count) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(payload);
+    switch (header.encoding) {
+    case ENCODING_DELTA_OF_DELTA:
+        TimeSeriesCodec::decodeTimestamps(bytes, header.byteSize, static_cast<int64_t*>(values), count);
+        break;
+    case ENCODING_XOR:
+        TimeSeriesCodec::decodeFloats(bytes, header.byteSize, static_cast<float*>(values), count);
+        break;
+    default:
+        std::memcpy(values, payload, header.byteSize);
+        break;
+    }
+}
+
+/**
+ * @brief Zapisuje blok kolumny wraz z nagłówkiem i dopełnieniem.
+ */
+static void writeBlock(std::ostream& out, uint32_t column, uint32_t encoding, const void* data, size_t size) {
+    static const char zeros[8] = {};
+
+    BlockHeader header = {};
+    header.column = column;
+    header.encoding = encoding;
+    header.byteSize = size;
+    header.checksum = Snapshot::checksum(data, size);
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    out.write(zeros, static_cast<std::streamsize>(Snapshot::padding(size)));
+}
+
+/**
+ * @brief Zapisuje wszystkie rekordy drzewa jako migawkę podzieloną na segmenty.
+ */
+void Snapshot::write(const TreeData& treeData, std::ostream& out, bool compressed) {
+    std::vector<int64_t> timestamps;
+    std::vector<float> channels[CHANNEL_COUNT];
+    treeData.exportColumns(timestamps, channels);
+
+    size_t recordCount = timestamps.size();
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    if (compressed) {
+        header.flags |= SNAPSHOT_COMPRESSED;
+    }
+    header.recordCount = recordCount;
+    header.minTimestamp = timestamps.empty() ? 0 : timestamps.front();
+    header.maxTimestamp = timestamps.empty() ? 0 : timestamps.back();
+    header.segmentCount = static_cast<uint32_t>((recordCount + SEGMENT_SIZE - 1) / SEGMENT_SIZE);
+    header.headerChecksum = checksum(&header, offsetof(FileHeader, headerChecksum));
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<uint8_t> encoded;
+    for (size_t first = 0; first < recordCount; first += SEGMENT_SIZE) {
+        size_t count = std::min(SEGMENT_SIZE, recordCount - first);
+
+        SegmentHeader segment = {};
+        segment.recordCount = count;
+        segment.firstTimestamp = timestamps[first];
+        segment.lastTimestamp = timestamps[first + count - 1];
+        segment.blockCount = BLOCK_COUNT;
+        out.write(reinterpret_cast<const char*>(&segment), sizeof(segment));
+
+        if (compressed) {
+            encoded.clear();
+            TimeSeriesCodec::encodeTimestamps(&timestamps[first], count, encoded);
+            writeBlock(out, 0, ENCODING_DELTA_OF_DELTA, encoded.data(), encoded.size());
+            for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                encoded.clear();
+                TimeSeriesCodec::encodeFloats(&channels[channel][first], count, encoded);
+                writeBlock(out, 1 + channel, ENCODING_XOR, encoded.data(), encoded.size());
+            }
+        } else {
+            writeBlock(out, 0, ENCODING_RAW, &timestamps[first], count * sizeof(int64_t));
+            for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                writeBlock(out, 1 + channel, ENCODING_RAW, &channels[channel][first], count * sizeof(float));
+            }
+        }
+    }
+
+    if (!out) {
+        throw std::runtime_error("Błąd zapisu migawki");
+    }
+}
+
+/**
+ * @brief Wczytuje blok, sprawdza jego sumę kontrolną i dekoduje go do tablicy wartości.
+ */
+static void readBlock(std::istream& in, uint32_t column, void* values, size_t count, std::vector<char>& payload) {
+    BlockHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("Nieoczekiwany koniec migawki");
+    }
+    Snapshot::validateBlock(header, column, count);
+
+    payload.resize(header.byteSize);
+    if (!in.read(payload.data(), static_cast<std::streamsize>(header.byteSize))) {
+        throw std::runtime_error("Nieoczekiwany koniec migawki");
+    }
+    if (Snapshot::checksum(payload.data(), payload.size()) != header.checksum) {
+        throw std::runtime_error("Niepoprawna suma kontrolna bloku migawki");
+    }
+    in.ignore(static_cast<std::streamsize>(Snapshot::padding(header.byteSize)));
+
+    Snapshot::decodeBlock(header, payload.data(), values, count);
+}
+
+/**
+ * @brief Wczytuje plik w starym formacie (kolejne rekordy `LineData` bez nagłówka).
+ */
+static void readLegacy(std::istream& in, TreeData& treeData) {
+    while (in.peek() != EOF) {
+        LineData lineData(in);
+        if (!in) {
+            throw std::runtime_error("Nieoczekiwany koniec pliku w starym formacie");
+        }
+        treeData.addData(lineData);
+    }
+}
+
+/**
+ * @brief Wczytuje segmenty migawki o sprawdzonym nagłówku.
+ */
+static void readSegments(std::istream& in, const FileHeader& header, TreeData& treeData) {
+    std::vector<int64_t> timestamps;
+    std::vector<float> channels[CHANNEL_COUNT];
+    std::vector<char> payload;
+    uint64_t loaded = 0;
+    for (uint32_t segmentIndex = 0; segmentIndex < header.segmentCount; ++segmentIndex) {
+        SegmentHeader segment;
+        if (!in.read(reinterpret_cast<char*>(&segment), sizeof(segment))) {
+            throw std::runtime_error("Nieoczekiwany koniec migawki");
+        }
+        if (segment.blockCount != Snapshot::BLOCK_COUNT || segment.recordCount == 0
+            || segment.recordCount > Snapshot::SEGMENT_SIZE) {
+            throw std::runtime_error("Niepoprawny nagłówek segmentu migawki");
+        }
+        if (segment.recordCount > header.recordCount - loaded) {
+            throw std::runtime_error("Niepoprawny nagłówek migawki");
+        }
+
+        size_t count = static_cast<size_t>(segment.recordCount);
+        timestamps.resize(count);
+        readBlock(in, 0, timestamps.data(), count, payload);
+        const float* columns[CHANNEL_COUNT];
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            channels[channel].resize(count);
+            readBlock(in, 1 + channel, channels[channel].data(), count, payload);
+            columns[channel] = channels[channel].data();
+        }
+
+        treeData.addColumns(timestamps.data(), columns, count);
+        loaded += segment.recordCount;
+    }
+
+    // Segmenty muszą zawierać dokładnie tyle rekordów, ile podaje nagłówek pliku
+    if (loaded != header.recordCount) {
+        throw std::runtime_error("Niepoprawny nagłówek migawki");
+    }
+}
+
+/**
+ * @brief Wczytuje migawkę i dodaje jej rekordy do drzewa.
+ */
+size_t Snapshot::read(std::istream& in, TreeData& treeData) {
+    // Rekordy trafiają najpierw do osobnego drzewa, więc uszkodzony plik nie zostawia w docelowym
+    // drzewie części danych, a duplikaty zapisane z drzewa `DUPLICATE_KEEP` nie są gubione
+    TreeData loadedTree;
+    loadedTree.setDuplicatePolicy(DUPLICATE_KEEP);
+
+    FileHeader header;
+    std::streampos start = in.tellg();
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        in.clear();
+        in.seekg(start);
+        readLegacy(in, loadedTree);
+    } else {
+        validateHeader(header);
+        readSegments(in, header, loadedTree);
+    }
+
+    size_t previousSize = treeData.size();
+    treeData.merge(std::move(loadedTree));
+    return treeData.size() - previousSize;
+}
@@ -0,0 +1,177 @@
+/**
+ * @file snapshot.hpp
+ * @brief Deklaracja klasy `Snapshot` zapisującej i wczytującej kolumnowe migawki danych (data.bin, wersja 2).
+ *
+ * ## Format pliku (little-endian):
+ * - `FileHeader`: sygnatura "PRJ6SNAP", wersja, flagi, liczba rekordów, zakres czasu,
+ *   liczba segmentów i suma kontrolna nagłówka.
+ * - Dla każdego segmentu: `SegmentHeader` (liczba rekordów i zakres czasu segmentu),
+ *   a po nim bloki kolumn: znaczniki czasu oraz po jednym bloku na kanał.
+ * - Każdy blok: `BlockHeader` (kolumna, kodowanie, rozmiar, CRC32 zawartości) i zawartość
+ *   dopełniona zerami do wielokrotności 8 bajtów.
+ *
+ * Wszystkie nagłówki mają rozmiary będące wielokrotnością 8 bajtów, więc zawartość bloków
+ * jest wyrównana i może być używana bezpośrednio z pliku odwzorowanego w pamięci.
+ *
+ * Migawka skompresowana (flaga `SNAPSHOT_COMPRESSED`) zapisuje znaczniki czasu kodowaniem
+ * delta-of-delta, a kanały kodowaniem XOR (zob. `TimeSeriesCodec`). Rekordy dzielone są na
+ * segmenty po `Snapshot::SEGMENT_SIZE`, więc zapytanie dekoduje tylko segmenty ze swojego zakresu.
+ */
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+#include "treeData.hpp"
+
+/**
+ * @enum BlockEncoding
+ * @brief Sposób zakodowania zawartości bloku kolumny.
+ */
+enum BlockEncoding : uint32_t {
+    ENCODING_RAW = 0,            ///< Wartości zapisane bezpośrednio (int64 lub float)
+    ENCODING_DELTA_OF_DELTA = 1, ///< Znaczniki czasu kodowane delta-of-delta
+    ENCODING_XOR = 2             ///< Wartości kanałów kodowane XOR
+};
+
+/**
+ * @enum SnapshotFlags
+ * @brief Flagi zapisywane w nagłówku pliku migawki.
+ */
+enum SnapshotFlags : uint32_t {
+    SNAPSHOT_COMPRESSED = 1 ///< Bloki kolumn są skompresowane
+};
+
+/**
+ * @struct FileHeader
+ * @brief Nagłówek pliku migawki.
+ */
+struct FileHeader {
+    char magic[8]; /**< Sygnatura "PRJ6SNAP". */
+    uint32_t version; /**< Wersja formatu. */
+    uint32_t flags; /**< Flagi formatu (`SnapshotFlags`). */
+    uint64_t recordCount; /**< Liczba rekordów w pliku. */
+    int64_t minTimestamp; /**< Najwcześniejszy znacznik czasu. */
+    int64_t maxTimestamp; /**< Najpóźniejszy znacznik czasu. */
+    uint32_t segmentCount; /**< Liczba segmentów. */
+    uint32_t headerChecksum; /**< CRC32 wcześniejszych pól nagłówka. */
+};
+
+/**
+ * @struct SegmentHeader
+ * @brief Nagłówek segmentu, czyli grupy kolejnych rekordów zapisanych kolumnowo.
+ */
+struct SegmentHeader {
+    uint64_t recordCount; /**< Liczba rekordów w segmencie. */
+    int64_t firstTimestamp; /**< Znacznik czasu pierwszego rekordu. */
+    int64_t lastTimestamp; /**< Znacznik czasu ostatniego rekordu. */
+    uint32_t blockCount; /**< Liczba bloków kolumn w segmencie. */
+    uint32_t reserved; /**< Zarezerwowane (0). */
+};
+
+/**
+ * @struct BlockHeader
+ * @brief Nagłówek bloku jednej kolumny w segmencie.
+ */
+struct BlockHeader {
+    uint32_t column; /**< Kolumna: 0 to znaczniki czasu, 1 + `Channel` to kanały. */
+    uint32_t encoding; /**< Kodowanie zawartości (`BlockEncoding`). */
+    uint64_t byteSize; /**< Rozmiar zawartości bez dopełnienia. */
+    uint32_t checksum; /**< CRC32 zawartości. */
+    uint32_t reserved; /**< Zarezerwowane (0). */
+};
+
+static_assert(sizeof(FileHeader) == 48, "FileHeader musi mieć 48 bajtów");
+static_assert(sizeof(SegmentHeader) == 32, "SegmentHeader musi mieć 32 bajty");
+static_assert(sizeof(BlockHeader) == 24, "BlockHeader musi mieć 24 bajty");
+
+/**
+ * @class Snapshot
+ * @brief Klasa narzędziowa zapisująca i wczytująca migawki `TreeData`.
+ *
+ * Wczytywanie czyta każdą kolumnę jednym odczytem i wypełnia drzewo hurtowo przez
+ * `TreeData::addColumns`. Pliki w starym formacie (rekordy `LineData` bez nagłówka)
+ * są rozpoznawane po braku sygnatury i wczytywane rekord po rekordzie.
+ */
+class Snapshot {
+public:
+    Snapshot() = delete;
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    static const uint32_t VERSION = 2; /**< Bieżąca wersja formatu. */
+    static const uint32_t BLOCK_COUNT = 1 + CHANNEL_COUNT; /**< Liczba bloków w segmencie. */
+    static constexpr size_t SEGMENT_SIZE = 4096; /**< Maksymalna liczba rekordów w segmencie. */
+
+    /**
+     * @brief Zapisuje wszystkie rekordy drzewa jako migawkę.
+     * @param treeData Drzewo do zapisania.
+     * @param out Strumień wyjściowy (binarny).
+     * @param compressed Czy kompresować bloki kolumn.
+     * @throws std::runtime_error Jeśli zapis się nie powiódł.
+     */
+    static void write(const TreeData& treeData, std::ostream& out, bool compressed = false);
+
+    /**
+     * @brief Wczytuje migawkę i dodaje jej rekordy do drzewa.
+     *
+     * Plik wczytywany jest w całości przed zmianą drzewa, więc błąd pozostawia drzewo bez zmian.
+     * Rekordy dołączane są przez `TreeData::merge`, a polityka duplikatów drzewa dotyczy tylko
+     * rekordów powtarzających istniejące w nim minuty.
+     *
+     * @param in Strumień wejściowy (binarny).
+     * @param treeData Drzewo docelowe.
+     * @return Liczba rekordów faktycznie dodanych do drzewa.
+     * @throws std::runtime_error Jeśli plik jest uszkodzony lub ma nieobsługiwaną wersję.
+     */
+    static size_t read(std::istream& in, TreeData& treeData);
+
+    /**
+     * @brief Oblicza sumę kontrolną CRC32 (IEEE 802.3).
+     * @param data Dane wejściowe.
+     * @param size Rozmiar danych w bajtach.
+     * @return Suma kontrolna.
+     */
+    static uint32_t checksum(const void* data, size_t size);
+
+    /**
+     * @brief Zwraca liczbę bajtów dopełnienia do wielokrotności 8.
+     */
+    static size_t padding(size_t size) { return (8 - size % 8) % 8; }
+
+    /**
+     * @brief Sprawdza poprawność nagłówka pliku (sygnatura, wersja, suma kontrolna).
+     * @param header Nagłówek odczytany z pliku.
+     * @throws std::runtime_error Jeśli nagłówek jest niepoprawny.
+     */
+    static void validateHeader(const FileHeader& header);
+
+    /**
+     * @brief Sprawdza, czy nagłówek bloku pasuje do kolumny i liczby rekordów segmentu.
+     * @param header Nagłówek bloku.
+     * @param column Oczekiwana kolumna.
+     * @param count Liczba rekordów w segmencie.
+     * @throws std::runtime_error Jeśli nagłówek jest niepoprawny, rozmiar bloku nie mieści się w granicach
+     * wynikających z liczby rekordów lub liczba rekordów przekracza `SEGMENT_SIZE`.
+     */
+    static void validateBlock(const BlockHeader& header, uint32_t column, size_t count);
+
+    /**
+     * @brief Dekoduje zawartość bloku do tablicy wartości kolumny.
+     * @param header Nagłówek bloku (sprawdzony przez `validateBlock`).
+     * @param payload Zawartość bloku.
+     * @param values Bufor wynikowy na `count` wartości (int64 lub float, zależnie od kolumny).
+     * @param count Liczba rekordów w segmencie.
+     * @throws std::runtime_error Jeśli zawartość jest uszkodzona.
+     */
+    static void decodeBlock(const BlockHeader& header, const void* payload, void* values, size_t count);
+
+    /** Sygnatura pliku migawki. */
+    static const char MAGIC[8];
+};
+
+#endif
@@ -0,0 +1,239 @@
+/**
+ * @file snapshotView.cpp
+ * @brief Implementacja klasy `SnapshotView`.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "dateTime.hpp"
+#include "snapshotView.hpp"
+
+/**
+ * @brief Otwiera plik migawki i odczytuje katalog segmentów.
+ */
+bool SnapshotView::open(const std::string& path) {
+    segments.clear();
+    recordCount = 0;
+    if (!file.open(path)) {
+        return false;
+    }
+
+    const char* data = file.data();
+    size_t size = file.size();
+    if (size < sizeof(FileHeader)) {
+        throw std::runtime_error("Plik nie jest migawką danych");
+    }
+
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    Snapshot::validateHeader(header);
+
+    size_t offset = sizeof(FileHeader);
+    int64_t previousTimestamp = INVALID_TIMESTAMP;
+    for (uint32_t segmentIndex = 0; segmentIndex < header.segmentCount; ++segmentIndex) {
+        if (size - offset < sizeof(SegmentHeader)) {
+            throw std::runtime_error("Nieoczekiwany koniec migawki");
+        }
+
+        Segment segment;
+        std::memcpy(&segment.header, data + offset, sizeof(SegmentHeader));
+        offset += sizeof(SegmentHeader);
+        // Liczba rekordów wyznacza zakres przeglądanych kolumn, więc musi być ograniczona przed ich użyciem
+        if (segment.header.blockCount != Snapshot::BLOCK_COUNT || segment.header.recordCount == 0
+            || segment.header.recordCount > Snapshot::SEGMENT_SIZE || segment.header.recordCount > header.recordCount
+            || segment.header.firstTimestamp < previousTimestamp) {
+            throw std::runtime_error("Niepoprawny nagłówek segmentu migawki");
+        }
+
+        for (uint32_t column = 0; column < Snapshot::BLOCK_COUNT; ++column) {
+            if (size - offset < sizeof(BlockHeader)) {
+                throw std::runtime_error("Nieoczekiwany koniec migawki");
+            }
+            const BlockHeader* block = reinterpret_cast<const BlockHeader*>(data + offset);
+            offset += sizeof(BlockHeader);
+
+            Snapshot::validateBlock(*block, column, segment.header.recordCount);
+            // Blok wraz z wyrównaniem musi mieścić się w pliku, inaczej `size - offset` przekręciłoby się
+            // przy odczycie następnego nagłówka; porównania na resztach nie mogą się przepełnić
+            if (block->byteSize > size - offset
+                || Snapshot::padding(block->byteSize) > size - offset - block->byteSize) {
+                throw std::runtime_error("Nieoczekiwany koniec migawki");
+            }
+
+            segment.blocks[column] = block;
+            offset += block->byteSize + Snapshot::padding(block->byteSize);
+        }
+
+        previousTimestamp = segment.header.lastTimestamp;
+        recordCount += segment.header.recordCount;
+        segments.push_back(segment);
+    }
+
+    if (recordCount != header.recordCount) {
+        throw std::runtime_error("Niepoprawny nagłówek migawki");
+    }
+    return true;
+}
+
+/**
+ * @brief Sprawdza sumy kontrolne wszystkich bloków.
+ */
+bool SnapshotView::verify() const {
+    for (const Segment& segment : segments) {
+        for (const BlockHeader* block : segment.blocks) {
+            const void* payload = block + 1;
+            if (Snapshot::checksum(payload, block->byteSize) != block->checksum) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Przygotowuje kolumny segmentu, dekodując bloki skompresowane.
+ */
+void SnapshotView::loadColumns(const Segment& segment, Columns& columns) {
+    size_t count = static_cast<size_t>(segment.header.recordCount);
+
+    const BlockHeader* block = segment.blocks[0];
+    if (block->encoding == ENCODING_RAW) {
+        columns.timestamps = reinterpret_cast<const int64_t*>(block + 1);
+    } else {
+        columns.timestampBuffer.resize(count);
+        Snapshot::decodeBlock(*block, block + 1, columns.timestampBuffer.data(), count);
+        columns.timestamps = columns.timestampBuffer.data();
+    }
+
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        block = segment.blocks[1 + channel];
+        if (block->encoding == ENCODING_RAW) {
+            columns.channels[channel] = reinterpret_cast<const float*>(block + 1);
+        } else {
+            columns.channelBuffers[channel].resize(count);
+            Snapshot::decodeBlock(*block, block + 1, columns.channelBuffers[channel].data(), count);
+            columns.channels[channel] = columns.channelBuffers[channel].data();
+        }
+    }
+}
+
+/**
+ * @brief Zwraca zakres indeksów rekordów segmentu leżących w przedziale [start, end].
+ */
+void SnapshotView::findRange(const Segment& segment, const Columns& columns, int64_t start, int64_t end,
+    size_t& begin, size_t& finish) {
+    const int64_t* first = columns.timestamps;
+    const int64_t* last = columns.timestamps + segment.header.recordCount;
+    begin = std::lower_bound(first, last, start) - first;
+    finish = std::upper_bound(first + begin, last, end) - first;
+}
+
+/**
+ * @brief Pobiera dane w zadanym przedziale dat.
+ */
+std::vector<LineData> SnapshotView::getDataBetweenDates(const std::string& startDate, const std::string& endDate) const {
+    std::vector<LineData> result;
+    forEachBetweenDates(startDate, endDate, [&result](const RecordView& record) {
+        result.push_back(record.toLineData());
+    });
+    return result;
+}
+
+/**
+ * @brief Agreguje rekordy z przedziału [start, end].
+ */
+Aggregate SnapshotView::aggregateBetween(int64_t start, int64_t end) const {
+    Aggregate result;
+    descendBetween(start, end, [&result](const Columns& columns, size_t begin, size_t finish) {
+        result.addColumns(columns.channels, begin, finish);
+    });
+    return result;
+}
+
+/**
+ * @brief Zwraca agregaty w zadanym przedziale dat.
+ */
+Aggregate SnapshotView::aggregateBetweenDates(const std::string& startDate, const std::string& endDate) const {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return Aggregate();
+    }
+
+    return aggregateBetween(start, end);
+}
+
+/**
+ * @brief Grupuje rekordy z przedziału dat w przedziały czasowe.
+ */
+std::vector<GroupRow> SnapshotView::groupBetweenDates(const std::string& startDate, const std::string& endDate,
+    const GroupBy& groupBy) const {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return std::vector<GroupRow>();
+    }
+
+    std::vector<RollupPoint> points;
+    descendBetween(start, end, [&](const Columns& columns, size_t begin, size_t finish) {
+        addColumnsToSeries(points, groupBy.bucket, columns.timestamps, columns.channels, begin, finish);
+    });
+    return selectGroups(points, groupBy);
+}
+
+/**
+ * @brief Oblicza sumy wartości w zadanym przedziale dat.
+ */
+void SnapshotView::calculateSumsBetweenDates(const std::string& startDate, const std::string& endDate,
+    float& autokonsumpcjaSum, float& eksportSum, float& importSum, float& poborSum, float& produkcjaSum) const {
+    Aggregate aggregate = aggregateBetweenDates(startDate, endDate);
+
+    autokonsumpcjaSum = static_cast<float>(aggregate.sum[AUTOKONSUMPCJA]);
+    eksportSum = static_cast<float>(aggregate.sum[EKSPORT]);
+    importSum = static_cast<float>(aggregate.sum[IMPORT]);
+    poborSum = static_cast<float>(aggregate.sum[POBOR]);
+    produkcjaSum = static_cast<float>(aggregate.sum[PRODUKCJA]);
+}
+
+/**
+ * @brief Oblicza średnie wartości w zadanym przedziale dat.
+ */
+void SnapshotView::calculateAveragesBetweenDates(const std::string& startDate, const std::string& endDate,
+    float& autokonsumpcjaAvg, float& eksportAvg, float& importAvg, float& poborAvg, float& produkcjaAvg) const {
+    Aggregate aggregate = aggregateBetweenDates(startDate, endDate);
+
+    autokonsumpcjaAvg = static_cast<float>(aggregate.average(AUTOKONSUMPCJA));
+    eksportAvg = static_cast<float>(aggregate.average(EKSPORT));
+    importAvg = static_cast<float>(aggregate.average(IMPORT));
+    poborAvg = static_cast<float>(aggregate.average(POBOR));
+    produkcjaAvg = static_cast<float>(aggregate.average(PRODUKCJA));
+}
+
+/**
+ * @brief Porównuje sumy pomiędzy dwoma przedziałami dat.
+ */
+void SnapshotView::compareDataBetweenDates(const std::string& startDate1, const std::string& endDate1,
+    const std::string& startDate2, const std::string& endDate2,
+    float& autokonsumpcjaDiff, float& eksportDiff, float& importDiff, float& poborDiff, float& produkcjaDiff) const {
+    float sums1[CHANNEL_COUNT], sums2[CHANNEL_COUNT];
+    calculateSumsBetweenDates(startDate1, endDate1, sums1[AUTOKONSUMPCJA], sums1[EKSPORT], sums1[IMPORT], sums1[POBOR], sums1[PRODUKCJA]);
+    calculateSumsBetweenDates(startDate2, endDate2, sums2[AUTOKONSUMPCJA], sums2[EKSPORT], sums2[IMPORT], sums2[POBOR], sums2[PRODUKCJA]);
+
+    autokonsumpcjaDiff = sums2[AUTOKONSUMPCJA] - sums1[AUTOKONSUMPCJA];
+    eksportDiff = sums2[EKSPORT] - sums1[EKSPORT];
+    importDiff = sums2[IMPORT] - sums1[IMPORT];
+    poborDiff = sums2[POBOR] - sums1[POBOR];
+    produkcjaDiff = sums2[PRODUKCJA] - sums1[PRODUKCJA];
+}
+
+/**
+ * @brief Wyszukuje rekordy z przedziału dat, których wartość kanału mieści się w tolerancji.
+ */
+std::vector<LineData> SnapshotView::searchRecordsWithTolerance(const std::string& startDate, const std::string& endDate,
+    float value, float tolerance, Channel channel) const {
+    std::vector<LineData> result;
+    forEachWithTolerance(startDate, endDate, value, tolerance, channel, [&result](const RecordView& record) {
+        result.push_back(record.toLineData());
+    });
+    return result;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file snapshotView.hpp
+ * @brief Deklaracja klasy `SnapshotView` odpowiadającej na zapytania bezpośrednio z pliku migawki odwzorowanego w pamięci.
+ */
+
+#ifndef SNAPSHOTVIEW_HPP
+#define SNAPSHOTVIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "aggregate.hpp"
+#include "dateTime.hpp"
+#include "groupBy.hpp"
+#include "lineData.hpp"
+#include "mappedFile.hpp"
+#include "recordView.hpp"
+#include "snapshot.hpp"
+
+/**
+ * @class SnapshotView
+ * @brief Widok tylko do odczytu na migawkę danych, bez budowania `TreeData`.
+ *
+ * Otwarcie widoku odwzorowuje plik w pamięci i odczytuje jedynie nagłówki segmentów i bloków,
+ * więc jego koszt zależy od liczby segmentów, a nie od liczby bajtów kolumn. Zapytania wyszukują binarnie zakres rekordów
+ * w kolumnie znaczników czasu i czytają tylko potrzebne kolumny, a system operacyjny wczytuje
+ * wyłącznie dotknięte strony. Wiele procesów otwierających ten sam plik współdzieli jedną kopię
+ * danych w pamięci podręcznej systemu.
+ *
+ * Bloki skompresowane dekodowane są dopiero wtedy, gdy zapytanie dotyka ich segmentu.
+ *
+ * Udostępnia ten sam zestaw zapytań co `TreeData`.
+ */
+class SnapshotView {
+public:
+    /**
+     * @brief Otwiera plik migawki.
+     * @param path Ścieżka do pliku migawki.
+     * @return `false`, jeśli pliku nie udało się otworzyć.
+     * @throws std::runtime_error Jeśli plik nie jest poprawną migawką.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Sprawdza sumy kontrolne wszystkich bloków (odczytuje cały plik).
+     * @return `true`, jeśli wszystkie bloki są poprawne.
+     */
+    bool verify() const;
+
+    /**
+     * @brief Zwraca liczbę rekordów w migawce.
+     */
+    size_t size() const { return recordCount; }
+
+    /**
+     * @brief Przekazuje kolejne rekordy z zadanego przedziału dat do funkcji odwiedzającej.
+     *
+     * Rekordy z bloków niekompresowanych czytane są bezpośrednio z odwzorowanego pliku.
+     *
+     * @param startDate Data początkowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param endDate Data końcowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param visitor Funkcja `void(const RecordView&)`.
+     * @return `false`, jeśli daty są niepoprawne.
+     */
+    template <typename Visitor>
+    bool forEachBetweenDates(const std::string& startDate, const std::string& endDate, Visitor&& visitor) const;
+
+    /**
+     * @brief Przekazuje do funkcji odwiedzającej rekordy, których wartość kanału mieści się w tolerancji.
+     * @param startDate Data początkowa.
+     * @param endDate Data końcowa.
+     * @param value Wartość do porównania.
+     * @param tolerance Tolerancja dla wartości.
+     * @param channel Przeszukiwany kanał.
+     * @param visitor Funkcja `void(const RecordView&)`.
+     * @return `false`, jeśli daty są niepoprawne.
+     */
+    template <typename Visitor>
+    bool forEachWithTolerance(const std::string& startDate, const std::string& endDate,
+        float value, float tolerance, Channel channel, Visitor&& visitor) const;
+
+    /**
+     * @brief Pobiera dane w zadanym przedziale dat.
+     * @param startDate Data początkowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param endDate Data końcowa (w formacie "dd.mm.yyyy hh:mm").
+     * @return Lista rekordów w kolejności chronologicznej.
+     */
+    std::vector<LineData> getDataBetweenDates(const std::string& startDate, const std::string& endDate) const;
+
+    /**
+     * @brief Zwraca agregaty (sumy, liczność, minima, maksima) w zadanym przedziale dat.
+     * @param startDate Data początkowa.
+     * @param endDate Data końcowa.
+     * @return Agregaty rekordów z zadanego przedziału.
+     */
+    Aggregate aggregateBetweenDates(const std::string& startDate, const std::string& endDate) const;
+
+    /**
+     * @brief Grupuje rekordy z przedziału dat w przedziały czasowe (jak `TreeData::groupBetweenDates`).
+     *
+     * Segmenty przeglądane są jednym przejściem, a rekordy każdego przedziału agregowane kolumnowo.
+     */
+    std::vector<GroupRow> groupBetweenDates(const std::string& startDate, const std::string& endDate,
+        const GroupBy& groupBy) const;
+
+    /**
+     * @brief Oblicza sumy wartości w zadanym przedziale dat (jak `TreeData::calculateSumsBetweenDates`).
+     */
+    void calculateSumsBetweenDates(const std::string& startDate, const std::string& endDate,
+        float& autokonsumpcjaSum, float& eksportSum, float& importSum, float& poborSum, float& produkcjaSum) const;
+
+    /**
+     * @brief Oblicza średnie wartości w zadanym przedziale dat (jak `TreeData::calculateAveragesBetweenDates`).
+     */
+    void calculateAveragesBetweenDates(const std::string& startDate, const std::string& endDate,
+        float& autokonsumpcjaAvg, float& eksportAvg, float& importAvg, float& poborAvg, float& produkcjaAvg) const;
+
+    /**
+     * @brief Porównuje sumy pomiędzy dwoma przedziałami dat (jak `TreeData::compareDataBetweenDates`).
+     */
+    void compareDataBetweenDates(const std::string& startDate1, const std::string& endDate1,
+        const std::string& startDate2, const std::string& endDate2,
+        float& autokonsumpcjaDiff, float& eksportDiff, float& importDiff,
+        float& poborDiff, float& produkcjaDiff) const;
+
+    /**
+     * @brief Wyszukuje rekordy z przedziału dat, których wartość kanału mieści się w tolerancji.
+     * @param startDate Data początkowa.
+     * @param endDate Data końcowa.
+     * @param value Wartość do porównania.
+     * @param tolerance Tolerancja dla wartości.
+     * @param channel Przeszukiwany kanał.
+     * @return Lista pasujących rekordów w kolejności chronologicznej.
+     */
+    std::vector<LineData> searchRecordsWithTolerance(const std::string& startDate, const std::string& endDate,
+        float value, float tolerance, Channel channel = AUTOKONSUMPCJA) const;
+
+private:
+    /**
+     * @struct Segment
+     * @brief Segment migawki wskazujący bezpośrednio na nagłówki bloków w odwzorowanym pliku.
+     */
+    struct Segment {
+        SegmentHeader header; /**< Nagłówek segmentu. */
+        const BlockHeader* blocks[Snapshot::BLOCK_COUNT]; /**< Nagłówki bloków kolumn. */
+    };
+
+    /**
+     * @struct Columns
+     * @brief Kolumny segmentu gotowe do odczytu.
+     *
+     * Dla bloków niekompresowanych wskaźniki prowadzą do odwzorowanego pliku, a dla
+     * skompresowanych do buforów z wartościami zdekodowanymi przez `loadColumns`.
+     */
+    struct Columns {
+        const int64_t* timestamps = nullptr; /**< Kolumna znaczników czasu. */
+        const float* channels[CHANNEL_COUNT] = {}; /**< Kolumny wartości kanałów. */
+        std::vector<int64_t> timestampBuffer; /**< Bufor zdekodowanych znaczników czasu. */
+        std::vector<float> channelBuffers[CHANNEL_COUNT]; /**< Bufory zdekodowanych kanałów. */
+    };
+
+    /**
+     * @brief Przygotowuje kolumny segmentu, dekodując bloki skompresowane.
+     * @throws std::runtime_error Jeśli zawartość bloku jest uszkodzona.
+     */
+    static void loadColumns(const Segment& segment, Columns& columns);
+
+    /**
+     * @brief Zwraca zakres indeksów [begin, end) rekordów segmentu leżących w przedziale [start, end].
+     */
+    static void findRange(const Segment& segment, const Columns& columns, int64_t start, int64_t end,
+        size_t& begin, size_t& finish);
+
+    /**
+     * @brief Przekazuje funkcji `onRange` kolumny i zakres indeksów każdego segmentu nachodzącego na [start, end].
+     * @param onRange Funkcja `void(const Columns&, size_t, size_t)`.
+     */
+    template <typename RangeFn>
+    void descendBetween(int64_t start, int64_t end, RangeFn&& onRange) const;
+
+    /**
+     * @brief Agreguje rekordy z przedziału [start, end].
+     */
+    Aggregate aggregateBetween(int64_t start, int64_t end) const;
+
+    MappedFile file; /**< Odwzorowany plik migawki. */
+    std::vector<Segment> segments; /**< Segmenty migawki w kolejności chronologicznej. */
+    size_t recordCount = 0; /**< Liczba rekordów w migawce. */
+};
+
+template <typename RangeFn>
+void SnapshotView::descendBetween(int64_t start, int64_t end, RangeFn&& onRange) const {
+    Columns columns;
+    for (const Segment& segment : segments) {
+        if (segment.header.lastTimestamp < start || segment.header.firstTimestamp > end) {
+            continue;
+        }
+
+        loadColumns(segment, columns);
+        size_t begin, finish;
+        findRange(segment, columns, start, end, begin, finish);
+        if (begin < finish) {
+            onRange(columns, begin, finish);
+        }
+    }
+}
+
+template <typename Visitor>
+bool SnapshotView::forEachBetweenDates(const std::string& startDate, const std::string& endDate, Visitor&& visitor) const {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return false;
+    }
+
+    descendBetween(start, end, [&visitor](const Columns& columns, size_t begin, size_t finish) {
+        for (size_t i = begin; i < finish; ++i) {
+            visitor(RecordView(columns.timestamps[i], columns.channels, i));
+        }
+    });
+
+    return true;
+}
+
+template <typename Visitor>
+bool SnapshotView::forEachWithTolerance(const std::string& startDate, const std::string& endDate,
+    float value, float tolerance, Channel channel, Visitor&& visitor) const {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return false;
+    }
+
+    float low = value - tolerance;
+    float high = value + tolerance;
+    descendBetween(start, end, [&](const Columns& columns, size_t begin, size_t finish) {
+        const float* values = columns.channels[channel];
+        for (size_t i = begin; i < finish; ++i) {
+            if (values[i] >= low && values[i] <= high) {
+                visitor(RecordView(columns.timestamps[i], columns.channels, i));
+            }
+        }
+    });
+
+    return true;
+}
+
+#endif
@@ -1,7 +1,29 @@
 #include <gtest/gtest.h>
+#include "csvLoader.hpp"
+#include "dataGenerator.hpp"
+#include "fileFollower.hpp"
 #include "lineData.hpp"
+#include "lineValidation.hpp"
+#include "queryExecutor.hpp"
+#include "queryServer.hpp"
+#include "snapshot.hpp"
+#include "snapshotView.hpp"
+#include "threadPool.hpp"
+#include "timeSeriesCodec.hpp"
 #include "treeData.hpp"
+#include "treeStore.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <sstream>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 // Testy dla klasy LineData
 class LineDataTest : public ::testing::Test {
@@ -99,3 +121,1005 @@ TEST_F(TreeDataTest, SearchRecordsWithToleranceTest) {
     EXPECT_FLOAT_EQ(result[0].getAutokonsumpcja(), 100.0f);
     EXPECT_FLOAT_EQ(result[1].getAutokonsumpcja(), 110.0f);
 }
+
+TEST_F(TreeDataTest, GetDataBetweenDatesTest) {
+    // Test odtwarzania rekordów z kolumn w zadanym przedziale czasowym
+    auto result = treeData.getDataBetweenDates("01.01.2023 13:00", "01.01.2023 14:00");
+
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0].getDate(), "01.01.2023 13:30");
+    EXPECT_FLOAT_EQ(result[0].getAutokonsumpcja(), 110.0f);
+    EXPECT_FLOAT_EQ(result[0].getProdukcja(), 85.0f);
+}
+
+TEST_F(TreeDataTest, AggregateBetweenDatesTest) {
+    // Test agregatów łączących całe poddrzewa z częściowo pokrytymi kwartałami
+    treeData.addData(LineData("02.01.2023 00:15", 5.0f, 1.0f, 2.0f, 3.0f, 4.0f));
+    treeData.addData(LineData("02.01.2023 20:45", 7.0f, 1.0f, 2.0f, 3.0f, 4.0f));
+
+    Aggregate all = treeData.aggregateBetweenDates("01.01.2023 00:00", "31.12.2023 23:59");
+    EXPECT_EQ(all.count, 4u);
+    EXPECT_DOUBLE_EQ(all.sum[AUTOKONSUMPCJA], 222.0);
+    EXPECT_FLOAT_EQ(all.min[AUTOKONSUMPCJA], 5.0f);
+    EXPECT_FLOAT_EQ(all.max[POBOR], 130.0f);
+
+    Aggregate partial = treeData.aggregateBetweenDates("01.01.2023 13:00", "02.01.2023 12:00");
+    EXPECT_EQ(partial.count, 2u);
+    EXPECT_DOUBLE_EQ(partial.sum[AUTOKONSUMPCJA], 115.0);
+}
+
+// Testy dla klasy CsvLoader
+TEST(CsvLoaderTest, LoadBufferTest) {
+    // Test wczytywania bufora z nagłówkiem, poprawnymi i niepoprawnymi liniami
+    const std::string csv =
+        "\"Time\",\"Autokonsumpcja\",\"Eksport\",\"Import\",\"Pobor\",\"Produkcja\"\r\n"
+        "\"01.01.2023 12:30\",\"100\",\"50\",\"30\",\"120\",\"80.5\"\r\n"
+        "\"01.01.2023 12:45\",\"1\",\"2\",\"3\",\"4\"\r\n"
+        "\"01.01.2023 13:00\",\"1\",\"2\",\"3\",\"4\",\"5\"";
+    TreeData treeData;
+
+    LoadStats stats = CsvLoader::loadBuffer(csv.data(), csv.size(), treeData);
+
+    EXPECT_EQ(stats.loadedLines, 2u);
+    EXPECT_EQ(stats.invalidLines, 2u);
+    Aggregate aggregate = treeData.aggregateBetweenDates("01.01.2023 00:00", "01.01.2023 23:59");
+    EXPECT_DOUBLE_EQ(aggregate.sum[PRODUKCJA], 85.5);
+}
+
+// Testy dla funkcji scanLine
+TEST(ScanLineTest, ErrorCodesTest) {
+    // Test kodów błędów zwracanych przez jednoprzebiegową walidację
+    auto scan = [](const std::string& line) {
+        ParsedLine parsed;
+        return scanLine(line.data(), line.data() + line.size(), parsed);
+    };
+
+    EXPECT_EQ(scan(""), LINE_EMPTY);
+    EXPECT_EQ(scan("\"Time\",\"Autokonsumpcja (W)\",\"Eksport (W)\",\"Import (W)\",\"Pobor (W)\",\"Produkcja (W)\""), LINE_HEADER);
+    EXPECT_EQ(scan("\"01.01.2023 12:30\",\"1\",\"x\",\"3\",\"4\",\"5\""), LINE_INVALID_CHARACTER);
+    EXPECT_EQ(scan("\"01.01.2023 12:30\",\"1\",\"2\",\"3\",\"4\""), LINE_FIELD_COUNT);
+    EXPECT_EQ(scan("\"32.01.2023 12:30\",\"1\",\"2\",\"3\",\"4\",\"5\""), LINE_INVALID_DATE);
+    EXPECT_EQ(scan("\"01.01.2023 12:30\",\"1\",\"2..5\",\"3\",\"4\",\"5\""), LINE_INVALID_NUMBER);
+}
+
+TEST(ScanLineTest, ParseFieldsTest) {
+    // Test odczytu pól z poprawnego wiersza
+    const std::string line = "\"01.01.2023 12:30\",\"100\",\"50.25\",\"-30\",\"120\",\"0.5\"\r";
+    ParsedLine parsed;
+
+    ASSERT_EQ(scanLine(line.data(), line.data() + line.size(), parsed), LINE_OK);
+    EXPECT_EQ(parsed.timestamp, makeTimestamp(2023, 1, 1, 12, 30));
+    EXPECT_FLOAT_EQ(parsed.values[AUTOKONSUMPCJA], 100.0f);
+    EXPECT_FLOAT_EQ(parsed.values[EKSPORT], 50.25f);
+    EXPECT_FLOAT_EQ(parsed.values[IMPORT], -30.0f);
+    EXPECT_FLOAT_EQ(parsed.values[PRODUKCJA], 0.5f);
+
+    // Białe znaki wokół pól i znak '+' akceptowane przez wcześniejsze `std::stof`
+    const std::string spaced = "\"01.01.2023 12:30\", 1.5,\"+0.25\", \"-3\" ,\" 4\t\",+5";
+    ASSERT_EQ(scanLine(spaced.data(), spaced.data() + spaced.size(), parsed), LINE_OK);
+    EXPECT_FLOAT_EQ(parsed.values[AUTOKONSUMPCJA], 1.5f);
+    EXPECT_FLOAT_EQ(parsed.values[EKSPORT], 0.25f);
+    EXPECT_FLOAT_EQ(parsed.values[IMPORT], -3.0f);
+    EXPECT_FLOAT_EQ(parsed.values[POBOR], 4.0f);
+    EXPECT_FLOAT_EQ(parsed.values[PRODUKCJA], 5.0f);
+
+    const std::string doubleSign = "\"01.01.2023 12:30\",\"+-1\",\"2\",\"3\",\"4\",\"5\"";
+    EXPECT_EQ(scanLine(doubleSign.data(), doubleSign.data() + doubleSign.size(), parsed), LINE_INVALID_NUMBER);
+}
+
+// Testy dla klasy Snapshot
+TEST_F(TreeDataTest, SnapshotRoundTripTest) {
+    // Test zapisu i odczytu migawki w formacie kolumnowym
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    Snapshot::write(treeData, stream);
+
+    TreeData restored;
+    EXPECT_EQ(Snapshot::read(stream, restored), 2u);
+    auto original = treeData.getDataBetweenDates("01.01.2023 00:00", "01.01.2023 23:59");
+    auto loaded = restored.getDataBetweenDates("01.01.2023 00:00", "01.01.2023 23:59");
+    ASSERT_EQ(loaded.size(), original.size());
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        EXPECT_EQ(loaded[i].getDate(), original[i].getDate());
+        EXPECT_FLOAT_EQ(loaded[i].getPobor(), original[i].getPobor());
+    }
+}
+
+TEST_F(TreeDataTest, SnapshotChecksumTest) {
+    // Test wykrywania uszkodzonej zawartości migawki
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    Snapshot::write(treeData, stream);
+    std::string bytes = stream.str();
+    bytes[bytes.size() - 8] ^= 0x01;
+
+    std::stringstream corrupted(bytes, std::ios::in | std::ios::binary);
+    TreeData restored;
+    EXPECT_THROW(Snapshot::read(corrupted, restored), std::runtime_error);
+}
+
+TEST_F(TreeDataTest, SnapshotViewTest) {
+    // Test zapytań bezpośrednio na pliku migawki
+    const char* path = "test_snapshot_view.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        Snapshot::write(treeData, out);
+    }
+
+    SnapshotView view;
+    ASSERT_TRUE(view.open(path));
+    EXPECT_TRUE(view.verify());
+    EXPECT_EQ(view.size(), treeData.size());
+
+    auto expected = treeData.getDataBetweenDates("01.01.2023 00:00", "01.01.2023 23:59");
+    auto actual = view.getDataBetweenDates("01.01.2023 00:00", "01.01.2023 23:59");
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        EXPECT_EQ(actual[i].getDate(), expected[i].getDate());
+        EXPECT_FLOAT_EQ(actual[i].getAutokonsumpcja(), expected[i].getAutokonsumpcja());
+    }
+
+    float sums[5], expectedSums[5];
+    view.calculateSumsBetweenDates("01.01.2023 00:00", "01.01.2023 23:59", sums[0], sums[1], sums[2], sums[3], sums[4]);
+    treeData.calculateSumsBetweenDates("01.01.2023 00:00", "01.01.2023 23:59",
+        expectedSums[0], expectedSums[1], expectedSums[2], expectedSums[3], expectedSums[4]);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_FLOAT_EQ(sums[i], expectedSums[i]);
+    }
+
+    EXPECT_EQ(view.searchRecordsWithTolerance("01.01.2023 00:00", "01.01.2023 12:59", 100.0f, 1.0f).size(), 1);
+    EXPECT_TRUE(view.getDataBetweenDates("02.01.2023 00:00", "03.01.2023 00:00").empty());
+
+    std::remove(path);
+}
+
+TEST_F(TreeDataTest, SnapshotRecordCountTest) {
+    // Test odrzucania migawki, której nagłówek podaje inną liczbę rekordów niż segmenty (widok i wczytywanie)
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    Snapshot::write(treeData, stream);
+    std::string bytes = stream.str();
+    FileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    header.recordCount += 1;
+    header.headerChecksum = Snapshot::checksum(&header, offsetof(FileHeader, headerChecksum));
+    std::memcpy(&bytes[0], &header, sizeof(header));
+
+    const char* path = "test_snapshot_count.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << bytes;
+    }
+    SnapshotView view;
+    EXPECT_THROW(view.open(path), std::runtime_error);
+    std::remove(path);
+
+    // Błąd wykrywany po ostatnim segmencie nie zostawia w drzewie części rekordów
+    std::stringstream corrupted(bytes, std::ios::in | std::ios::binary);
+    TreeData restored;
+    EXPECT_THROW(Snapshot::read(corrupted, restored), std::runtime_error);
+    EXPECT_EQ(restored.size(), 0u);
+}
+
+TEST_F(TreeDataTest, SnapshotSegmentSizeTest) {
+    // Test odrzucania segmentu z liczbą rekordów, dla której rozmiar bloku przekręca się do zapisanego
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    Snapshot::write(treeData, stream);
+    std::string bytes = stream.str();
+    SegmentHeader segment;
+    std::memcpy(&segment, &bytes[sizeof(FileHeader)], sizeof(segment));
+    segment.recordCount += uint64_t(1) << 61;
+    std::memcpy(&bytes[sizeof(FileHeader)], &segment, sizeof(segment));
+
+    std::stringstream corrupted(bytes, std::ios::in | std::ios::binary);
+    TreeData restored;
+    EXPECT_THROW(Snapshot::read(corrupted, restored), std::runtime_error);
+
+    // Widok zgłasza błąd przy otwarciu zamiast czytać kolumny poza odwzorowaniem pliku
+    const char* path = "test_snapshot_segment.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << bytes;
+    }
+    SnapshotView view;
+    EXPECT_THROW(view.open(path), std::runtime_error);
+    std::remove(path);
+}
+
+TEST(SnapshotTest, KeepDuplicatesTest) {
+    // Test zachowania rekordów z powtórzoną minutą przy ponownym wczytaniu migawki
+    TreeData source;
+    source.setDuplicatePolicy(DUPLICATE_KEEP);
+    source.addData(LineData("27.10.2024 02:30", 1.0f, 2.0f, 3.0f, 4.0f, 5.0f));
+    source.addData(LineData("27.10.2024 02:30", 6.0f, 7.0f, 8.0f, 9.0f, 10.0f));
+    ASSERT_EQ(source.size(), 2u);
+
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    Snapshot::write(source, stream);
+    TreeData restored;
+    EXPECT_EQ(Snapshot::read(stream, restored), 2u);
+    EXPECT_EQ(restored.size(), 2u);
+}
+
+TEST_F(TreeDataTest, CompressedSnapshotTest) {
+    // Test zapisu i odczytu migawki skompresowanej obejmującej kilka segmentów
+    TreeData source;
+    const float values[5] = { 1.5f, 0.0f, 2.25f, 0.0f, 10.0f };
+    for (int i = 0; i < 10000; ++i) {
+        float record[5];
+        for (int channel = 0; channel < 5; ++channel) {
+            record[channel] = values[channel] + (i % 7) * 0.25f;
+        }
+        source.addRecord(27000000 + i * 15 + (i % 500 == 0 ? 3 : 0), record);
+    }
+
+    std::stringstream compressed(std::ios::in | std::ios::out | std::ios::binary);
+    std::stringstream raw(std::ios::in | std::ios::out | std::ios::binary);
+    Snapshot::write(source, compressed, true);
+    Snapshot::write(source, raw);
+    EXPECT_LT(compressed.str().size() * 4, raw.str().size());
+
+    TreeData restored;
+    EXPECT_EQ(Snapshot::read(compressed, restored), source.size());
+
+    std::vector<int64_t> expectedTimestamps, actualTimestamps;
+    std::vector<float> expectedChannels[5], actualChannels[5];
+    source.exportColumns(expectedTimestamps, expectedChannels);
+    restored.exportColumns(actualTimestamps, actualChannels);
+    EXPECT_EQ(actualTimestamps, expectedTimestamps);
+    for (int channel = 0; channel < 5; ++channel) {
+        EXPECT_EQ(actualChannels[channel], expectedChannels[channel]);
+    }
+}
+
+TEST(TimeSeriesCodecTest, RoundTripTest) {
+    // Test kodowania wartości nieregularnych: skoki czasu, zera, wartości ujemne i skrajne
+    const int64_t timestamps[] = { -5, 0, 15, 30, 45, 10000, 10001, 9000, INT64_C(1) << 40, (INT64_C(1) << 40) + 15 };
+    const float values[] = { 0.0f, 0.0f, -0.0f, 1.0f, 1.0f, -3.75f, 1e30f, 1e-30f, 0.1f, 0.0f };
+    const size_t count = sizeof(timestamps) / sizeof(timestamps[0]);
+
+    std::vector<uint8_t> encodedTimestamps, encodedValues;
+    TimeSeriesCodec::encodeTimestamps(timestamps, count, encodedTimestamps);
+    TimeSeriesCodec::encodeFloats(values, count, encodedValues);
+
+    int64_t decodedTimestamps[count];
+    float decodedValues[count];
+    TimeSeriesCodec::decodeTimestamps(encodedTimestamps.data(), encodedTimestamps.size(), decodedTimestamps, count);
+    TimeSeriesCodec::decodeFloats(encodedValues.data(), encodedValues.size(), decodedValues, count);
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(decodedTimestamps[i], timestamps[i]);
+        EXPECT_EQ(std::memcmp(&decodedValues[i], &values[i], sizeof(float)), 0);
+    }
+
+    // Za krótkie dane muszą zostać wykryte
+    EXPECT_THROW(TimeSeriesCodec::decodeFloats(encodedValues.data(), 2, decodedValues, count), std::runtime_error);
+}
+
+TEST(AggregateTest, AddColumnsTest) {
+    // Test jąder wektorowych: wynik musi zgadzać się z dodawaniem rekord po rekordzie
+    std::vector<float> channels[5];
+    for (int i = 0; i < 1003; ++i) {
+        for (int channel = 0; channel < 5; ++channel) {
+            channels[channel].push_back(static_cast<float>((i * 37 + channel * 11) % 101) * 0.1f - 3.0f);
+        }
+    }
+    const float* columns[5];
+    for (int channel = 0; channel < 5; ++channel) {
+        columns[channel] = channels[channel].data();
+    }
+
+    Aggregate expected, actual;
+    for (size_t i = 5; i < 1000; ++i) {
+        float values[5];
+        for (int channel = 0; channel < 5; ++channel) {
+            values[channel] = channels[channel][i];
+        }
+        expected.add(values);
+    }
+    actual.addColumns(columns, 5, 1000);
+
+    EXPECT_EQ(actual.count, expected.count);
+    for (int channel = 0; channel < 5; ++channel) {
+        EXPECT_NEAR(actual.sum[channel], expected.sum[channel], 1e-9);
+        EXPECT_EQ(actual.min[channel], expected.min[channel]);
+        EXPECT_EQ(actual.max[channel], expected.max[channel]);
+    }
+}
+
+TEST_F(TreeDataTest, SearchRecordsByChannelTest) {
+    // Test wyszukiwania po wybranym kanale z uwzględnieniem zakresu dat, z indeksem i bez
+    treeData.addData(LineData("02.01.2023 08:00", 1.0f, 2.0f, 3.0f, 130.0f, 5.0f));
+
+    for (int pass = 0; pass < 2; ++pass) {
+        auto result = treeData.searchRecordsWithTolerance("01.01.2023 00:00", "02.01.2023 23:59", 128.0f, 3.0f, POBOR);
+        ASSERT_EQ(result.size(), 2);
+        EXPECT_EQ(result[0].getDate(), "01.01.2023 13:30");
+        EXPECT_EQ(result[1].getDate(), "02.01.2023 08:00");
+
+        result = treeData.searchRecordsWithTolerance("01.01.2023 13:00", "01.01.2023 23:59", 120.0f, 15.0f, POBOR);
+        ASSERT_EQ(result.size(), 1);
+        EXPECT_EQ(result[0].getDate(), "01.01.2023 13:30");
+
+        EXPECT_TRUE(treeData.searchRecordsWithTolerance("01.01.2023 00:00", "02.01.2023 23:59", 50.0f, 1.0f, POBOR).empty());
+        treeData.buildIndexes();
+    }
+}
+
+TEST_F(TreeDataTest, PredicateQueryTest) {
+    // Test zapytań z warunkiem złożonym na kilku kanałach
+    treeData.addData(LineData("02.01.2023 08:00", 1.0f, 2.5f, 0.05f, 130.0f, 5.0f));
+    treeData.addData(LineData("02.01.2023 09:00", 1.0f, 3.0f, 0.5f, 130.0f, 5.0f));
+
+    Predicate predicate = Predicate::greater(EKSPORT, 2.0f) && Predicate::less(IMPORT, 0.1f);
+    auto result = treeData.getDataBetweenDates("01.01.2023 00:00", "31.01.2023 23:59", predicate);
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0].getDate(), "02.01.2023 08:00");
+
+    Predicate either = Predicate::equal(AUTOKONSUMPCJA, 110.0f) || Predicate::between(IMPORT, 0.4f, 0.6f);
+    Aggregate aggregate = treeData.aggregateBetweenDates("01.01.2023 00:00", "31.01.2023 23:59", either);
+    EXPECT_EQ(aggregate.count, 2);
+    EXPECT_DOUBLE_EQ(aggregate.sum[AUTOKONSUMPCJA], 111.0);
+
+    aggregate = treeData.aggregateBetweenDates("01.01.2023 00:00", "31.01.2023 23:59", Predicate::lessEqual(POBOR, 130.0f));
+    EXPECT_EQ(aggregate.count, 4);
+    EXPECT_TRUE(treeData.getDataBetweenDates("01.01.2023 00:00", "31.01.2023 23:59", Predicate::greater(POBOR, 130.0f)).empty());
+}
+
+TEST_F(TreeDataTest, ForEachBetweenDatesTest) {
+    // Test przeglądania rekordów bez kopiowania
+    std::vector<int64_t> timestamps;
+    float sum = 0.0f;
+    bool valid = treeData.forEachBetweenDates("01.01.2023 00:00", "01.01.2023 23:59", [&](const RecordView& record) {
+        timestamps.push_back(record.getTimestamp());
+        sum += record.getValue(EKSPORT);
+    });
+
+    EXPECT_TRUE(valid);
+    ASSERT_EQ(timestamps.size(), 2);
+    EXPECT_LT(timestamps[0], timestamps[1]);
+    EXPECT_FLOAT_EQ(sum, 105.0f);
+
+    std::ostringstream out;
+    treeData.forEachWithTolerance("01.01.2023 00:00", "01.01.2023 23:59", 100.0f, 1.0f, AUTOKONSUMPCJA,
+        [&out](const RecordView& record) { record.print(out); });
+    EXPECT_EQ(out.str(), "01.01.2023 12:30 100 50 30 120 80\n");
+
+    EXPECT_FALSE(treeData.forEachBetweenDates("nie data", "01.01.2023 23:59", [](const RecordView&) {}));
+}
+
+TEST_F(TreeDataTest, QueryExecutorTest) {
+    // Test wykonywania skryptu zapytań z wynikami w CSV i JSON
+    std::string script =
+        "# komentarz\n"
+        "range 01.01.2023 00:00 01.01.2023 13:00\n"
+        "sum 01.01.2023 00:00 01.01.2023 23:59\n"
+        "search 01.01.2023 00:00 01.01.2023 23:59 pobor 128 3\n"
+        "avg 32.01.2023 00:00 01.01.2023 23:59\n"
+        "nieznane\n";
+
+    QueryExecutor csv(treeData, FORMAT_CSV);
+    std::istringstream in(script);
+    std::ostringstream out, errors;
+    csv.writeHeader(out);
+    EXPECT_EQ(csv.executeScript(in, out, errors), 2);
+    EXPECT_EQ(csv.getQueryCount(), 5);
+    EXPECT_EQ(out.str(),
+        "query,command,date,autokonsumpcja,eksport,import,pobor,produkcja\n"
+        "1,range,01.01.2023 12:30,100,50,30,120,80\n"
+        "2,sum,,210,105,65,250,165\n"
+        "3,search,01.01.2023 13:30,110,55,35,130,85\n");
+    EXPECT_NE(errors.str().find("Zapytanie 4"), std::string::npos);
+
+    QueryExecutor json(treeData, FORMAT_JSON);
+    std::ostringstream jsonOut;
+    json.execute("compare 01.01.2023 12:00 01.01.2023 12:59 01.01.2023 13:00 01.01.2023 13:59", jsonOut);
+    EXPECT_EQ(jsonOut.str(), "{\"query\":1,\"command\":\"compare\",\"values\":"
+        "{\"autokonsumpcja\":10,\"eksport\":5,\"import\":5,\"pobor\":10,\"produkcja\":5}}\n");
+    EXPECT_THROW(json.execute("search 01.01.2023 00:00 01.01.2023 23:59 moc 1 1", jsonOut), std::invalid_argument);
+}
+
+TEST(DataGeneratorTest, CsvMatchesTreeTest) {
+    // Test zgodności danych generowanych do CSV i bezpośrednio do drzewa
+    GeneratorOptions options;
+    options.recordCount = 5000;
+    options.gapRate = 0.01;
+    options.malformedRate = 0.01;
+
+    DataGenerator csvGenerator(options);
+    std::ostringstream out;
+    csvGenerator.writeCsv(out);
+    EXPECT_GT(csvGenerator.getMalformedCount(), 0);
+
+    TreeData loaded;
+    std::string csv = out.str();
+    LoadStats stats = CsvLoader::loadBuffer(csv.data(), csv.size(), loaded);
+    EXPECT_EQ(stats.loadedLines, 5000);
+    EXPECT_EQ(stats.invalidLines, csvGenerator.getMalformedCount() + 1);  // Nagłówek też jest odrzucany
+
+    TreeData generated;
+    DataGenerator(options).fill(generated);
+    Aggregate expected = generated.aggregateBetweenDates("01.01.2020 00:00", "31.12.2020 23:59");
+    Aggregate actual = loaded.aggregateBetweenDates("01.01.2020 00:00", "31.12.2020 23:59");
+    EXPECT_EQ(actual.count, 5000);
+    EXPECT_EQ(expected.count, 5000);
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        EXPECT_NEAR(actual.sum[channel], expected.sum[channel], 1e-3);
+    }
+
+    // W nocy produkcja jest zerowa, a pobór pokrywany jest importem
+    Aggregate night = generated.aggregateBetweenDates("02.01.2020 00:00", "02.01.2020 03:59");
+    EXPECT_EQ(night.max[PRODUKCJA], 0.0f);
+    EXPECT_NEAR(night.sum[IMPORT], night.sum[POBOR], 1e-3);
+    EXPECT_GT(expected.max[PRODUKCJA], 0.0f);
+}
+
+TEST(FileFollowerTest, IncrementalPollTest) {
+    // Test wczytywania tylko dopisanych, pełnych wierszy
+    const char* path = "test_follow.csv";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "\"Time\",\"A\",\"E\",\"I\",\"P\",\"Pr\"\n";
+        out << "\"01.01.2023 12:30\",\"1\",\"2\",\"3\",\"4\",\"5\"\n";
+    }
+
+    TreeData treeData;
+    FileFollower follower(path);
+    LoadStats stats;
+    ASSERT_TRUE(follower.poll(treeData, stats));
+    EXPECT_EQ(stats.loadedLines, 1);
+    EXPECT_EQ(stats.invalidLines, 1);
+
+    ASSERT_TRUE(follower.poll(treeData, stats));
+    EXPECT_EQ(stats.loadedLines, 0);
+    EXPECT_EQ(treeData.size(), 1);
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out << "\"01.01.2023 12:45\",\"1\",\"2\",\"3\",\"4\",\"5\"\n\"01.01.2023 13";
+    }
+    ASSERT_TRUE(follower.poll(treeData, stats));
+    EXPECT_EQ(stats.loadedLines, 1);
+    EXPECT_EQ(stats.invalidLines, 0);
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out << ":00\",\"1\",\"2\",\"3\",\"4\",\"5\"\n";
+    }
+    EXPECT_TRUE(follower.waitForChange(100));
+    ASSERT_TRUE(follower.poll(treeData, stats));
+    EXPECT_EQ(stats.loadedLines, 1);
+    EXPECT_EQ(stats.invalidLines, 0);
+
+    Aggregate aggregate = treeData.aggregateBetweenDates("01.01.2023 00:00", "01.01.2023 23:59");
+    EXPECT_EQ(aggregate.count, 3);
+    EXPECT_DOUBLE_EQ(aggregate.sum[PRODUKCJA], 15.0);
+
+    std::remove(path);
+    EXPECT_FALSE(follower.poll(treeData, stats));
+}
+
+TEST_F(TreeDataTest, DuplicatePolicyTest) {
+    // Test obsługi rekordów o istniejącym znaczniku czasu
+    float values[CHANNEL_COUNT] = {1.0f, 2.0f, 3.0f, 200.0f, 5.0f};
+    int64_t timestamp;
+    ASSERT_TRUE(parseTimestamp("01.01.2023 12:30", timestamp));
+
+    treeData.addRecord(timestamp, values);
+    EXPECT_EQ(treeData.size(), 2);
+    EXPECT_EQ(treeData.getDuplicateCount(), 1);
+    EXPECT_FLOAT_EQ(treeData.aggregateBetweenDates("01.01.2023 00:00", "01.01.2023 23:59").max[POBOR], 130.0f);
+
+    treeData.setDuplicatePolicy(DUPLICATE_REPLACE);
+    treeData.addRecord(timestamp, values);
+    Aggregate aggregate = treeData.aggregateBetweenDates("01.01.2023 00:00", "01.01.2023 23:59");
+    EXPECT_EQ(aggregate.count, 2);
+    EXPECT_DOUBLE_EQ(aggregate.sum[AUTOKONSUMPCJA], 111.0);
+    EXPECT_FLOAT_EQ(aggregate.max[POBOR], 200.0f);
+    EXPECT_FLOAT_EQ(treeData.aggregateBetweenDates("01.01.2023 00:00", "31.12.2023 23:59").min[AUTOKONSUMPCJA], 1.0f);
+
+    // Ponowne wczytanie tych samych danych nie zmienia sum
+    std::string csv = "\"01.01.2023 12:30\",\"1\",\"2\",\"3\",\"200\",\"5\"\n"
+                      "\"01.01.2023 12:45\",\"7\",\"7\",\"7\",\"7\",\"7\"\n";
+    treeData.setDuplicatePolicy(DUPLICATE_SKIP);
+    LoadStats stats = CsvLoader::loadBuffer(csv.data(), csv.size(), treeData);
+    EXPECT_EQ(stats.loadedLines, 2);
+    EXPECT_EQ(stats.duplicateLines, 1);
+    stats = CsvLoader::loadBuffer(csv.data(), csv.size(), treeData);
+    EXPECT_EQ(stats.duplicateLines, 2);
+    EXPECT_EQ(treeData.size(), 3);
+
+    treeData.setDuplicatePolicy(DUPLICATE_KEEP);
+    treeData.addRecord(timestamp, values);
+    EXPECT_EQ(treeData.size(), 4);
+}
+
+TEST(CalendarSlotsTest, OccupancyAndRangeTest) {
+    // Test tablicy pozycji kalendarzowych: iteracja tylko po zajętych pozycjach w kolejności kluczy
+    CalendarSlots<int, 31, 1> days;
+    EXPECT_TRUE(days.empty());
+    days[31] = 310;
+    days[1] = 10;
+    days[15] = 150;
+
+    EXPECT_EQ(days.size(), 3u);
+    EXPECT_TRUE(days.contains(15));
+    EXPECT_FALSE(days.contains(2));
+    EXPECT_EQ(days.find(2), nullptr);
+    EXPECT_FALSE(days.contains(0));
+
+    std::vector<int> all(days.begin(), days.end());
+    EXPECT_EQ(all, std::vector<int>({10, 150, 310}));
+
+    const CalendarSlots<int, 31, 1>& constDays = days;
+    std::vector<int> middle;
+    for (int value : constDays.range(2, 31)) {
+        middle.push_back(value);
+    }
+    EXPECT_EQ(middle, std::vector<int>({150, 310}));
+    EXPECT_EQ(constDays.range(16, 30).begin(), constDays.range(16, 30).end());
+}
+
+TEST_F(TreeDataTest, SparseYearsTest) {
+    // Test katalogu lat rozszerzanego w obie strony, z latami bez rekordów pomiędzy
+    treeData.addData(LineData("15.06.2026 08:00", 1.0f, 1.0f, 1.0f, 1.0f, 1.0f));
+    treeData.addData(LineData("31.12.2019 23:45", 2.0f, 2.0f, 2.0f, 2.0f, 2.0f));
+
+    auto result = treeData.getDataBetweenDates("01.01.2019 00:00", "31.12.2030 23:59");
+    ASSERT_EQ(result.size(), 4u);
+    EXPECT_EQ(result[0].getDate(), "31.12.2019 23:45");
+    EXPECT_EQ(result[1].getDate(), "01.01.2023 12:30");
+    EXPECT_EQ(result[3].getDate(), "15.06.2026 08:00");
+
+    Aggregate gap = treeData.aggregateBetweenDates("01.01.2020 00:00", "31.12.2022 23:59");
+    EXPECT_EQ(gap.count, 0u);
+    Aggregate tail = treeData.aggregateBetweenDates("01.02.2023 00:00", "01.01.2027 00:00");
+    EXPECT_EQ(tail.count, 1u);
+    EXPECT_DOUBLE_EQ(tail.sum[PRODUKCJA], 1.0);
+    EXPECT_EQ(treeData.size(), 4u);
+}
+
+TEST_F(TreeDataTest, ArenaReuseTest) {
+    // Test drzewa przeniesionego, wyczyszczonego i scalonego z drzewem o innej arenie
+    TreeData other;
+    other.addData(LineData("01.01.2023 18:00", 1.0f, 1.0f, 1.0f, 1.0f, 1.0f));
+    treeData.merge(std::move(other));
+    other = TreeData();
+
+    TreeData moved(std::move(treeData));
+    EXPECT_EQ(moved.size(), 3u);
+    EXPECT_DOUBLE_EQ(moved.aggregateBetweenDates("01.01.2023 00:00", "01.01.2023 23:59").sum[AUTOKONSUMPCJA], 211.0);
+
+    moved.clear();
+    EXPECT_EQ(moved.size(), 0u);
+    moved.addData(LineData("02.01.2023 06:15", 4.0f, 4.0f, 4.0f, 4.0f, 4.0f));
+    moved.buildIndexes();
+    auto result = moved.searchRecordsWithTolerance("01.01.2023 00:00", "31.12.2023 23:59", 4.0f, 0.1f);
+    ASSERT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].getDate(), "02.01.2023 06:15");
+
+    treeData = std::move(moved);
+    treeData.addData(LineData("03.01.2023 06:15", 5.0f, 5.0f, 5.0f, 5.0f, 5.0f));
+    EXPECT_EQ(treeData.size(), 2u);
+}
+
+TEST(RollupTest, SeriesMatchesRecordsTest) {
+    // Test serii godzinowych, dobowych i miesięcznych względem agregacji pojedynczych rekordów
+    GeneratorOptions options;
+    options.recordCount = 5000;
+    options.gapRate = 0.05;
+    TreeData treeData;
+    DataGenerator(options).fill(treeData);
+
+    std::string from = "01.01.2020 10:20";
+    std::string to = "15.02.2020 07:10";
+    int64_t start, end;
+    ASSERT_TRUE(parseTimestamp(from, start));
+    ASSERT_TRUE(parseTimestamp(to, end));
+
+    Aggregate scanned;
+    float values[CHANNEL_COUNT];
+    treeData.forEachBetweenDates(from, to, [&](const RecordView& record) {
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            values[channel] = record.getValue(static_cast<Channel>(channel));
+        }
+        scanned.add(values);
+    });
+    Aggregate total = treeData.aggregateBetweenDates(from, to);
+    EXPECT_EQ(total.count, scanned.count);
+    EXPECT_NEAR(total.sum[PRODUKCJA], scanned.sum[PRODUKCJA], 1e-3);
+    EXPECT_EQ(total.max[POBOR], scanned.max[POBOR]);
+
+    for (Resolution resolution : {RESOLUTION_HOUR, RESOLUTION_DAY, RESOLUTION_MONTH}) {
+        std::vector<RollupPoint> points = treeData.rollupBetweenDates(from, to, resolution);
+        ASSERT_FALSE(points.empty());
+        uint64_t count = 0;
+        double sum = 0.0;
+        for (size_t i = 0; i < points.size(); ++i) {
+            count += points[i].aggregate.count;
+            sum += points[i].aggregate.sum[PRODUKCJA];
+            if (i > 0) {
+                EXPECT_LT(points[i - 1].timestamp, points[i].timestamp);
+            }
+        }
+        EXPECT_EQ(count, total.count);
+        EXPECT_NEAR(sum, total.sum[PRODUKCJA], 1e-3);
+    }
+
+    std::vector<RollupPoint> hours = treeData.rollupBetweenDates(from, to, RESOLUTION_HOUR);
+    for (const RollupPoint& point : hours) {
+        int64_t first = std::max(start, point.timestamp);
+        int64_t last = std::min(end, point.timestamp + 59);
+        ASSERT_EQ(point.aggregate.count, treeData.aggregateBetweenDates(formatTimestamp(first), formatTimestamp(last)).count);
+    }
+    std::vector<RollupPoint> months = treeData.rollupBetweenDates(from, to, RESOLUTION_MONTH);
+    ASSERT_EQ(months.size(), 2u);
+    EXPECT_EQ(formatTimestamp(months[1].timestamp), "01.02.2020 00:00");
+
+    EXPECT_EQ(TreeData::selectResolution(from, to, 2000), RESOLUTION_HOUR);
+    EXPECT_EQ(TreeData::selectResolution(from, to, 100), RESOLUTION_DAY);
+    EXPECT_EQ(TreeData::selectResolution(from, to, 10), RESOLUTION_MONTH);
+}
+
+TEST(GroupByTest, BucketsMatchRangeQueriesTest) {
+    // Test grupowania w przedziały względem osobnych zapytań i względem migawki
+    GeneratorOptions options;
+    options.recordCount = 40000;
+    options.gapRate = 0.02;
+    TreeData treeData;
+    DataGenerator(options).fill(treeData);
+
+    const char* path = "test_group_by.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        Snapshot::write(treeData, out);
+    }
+    SnapshotView view;
+    ASSERT_TRUE(view.open(path));
+
+    std::string from = "03.01.2020 07:50";
+    std::string to = "20.02.2021 16:20";
+    int64_t start, end;
+    ASSERT_TRUE(parseTimestamp(from, start));
+    ASSERT_TRUE(parseTimestamp(to, end));
+
+    GroupBy groupBy;
+    groupBy.channels = {PRODUKCJA, POBOR};
+    groupBy.functions = {FUNCTION_SUM, FUNCTION_MAX, FUNCTION_COUNT};
+    for (BucketSize bucket : {BUCKET_15_MIN, BUCKET_HOUR, BUCKET_DAY, BUCKET_WEEK, BUCKET_MONTH, BUCKET_YEAR}) {
+        groupBy.bucket = bucket;
+        std::vector<GroupRow> rows = treeData.groupBetweenDates(from, to, groupBy);
+        std::vector<GroupRow> viewRows = view.groupBetweenDates(from, to, groupBy);
+        ASSERT_EQ(rows.size(), viewRows.size()) << bucketSizeName(bucket);
+
+        uint64_t count = 0;
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const GroupRow& row = rows[i];
+            ASSERT_EQ(row.values.size(), 6u);
+            EXPECT_EQ(row.timestamp, bucketStart(row.timestamp, bucket));
+            EXPECT_EQ(row.timestamp, viewRows[i].timestamp);
+            EXPECT_EQ(row.count, viewRows[i].count);
+            EXPECT_NEAR(row.values[0], viewRows[i].values[0], 1e-3);
+            EXPECT_EQ(row.values[2], static_cast<double>(row.count));
+            count += row.count;
+        }
+        EXPECT_EQ(count, treeData.aggregateBetweenDates(from, to).count) << bucketSizeName(bucket);
+
+        // Przedział ze środka zakresu liczony osobnym zapytaniem
+        const GroupRow& middle = rows[rows.size() / 2];
+        Aggregate expected = treeData.aggregateBetweenDates(formatTimestamp(std::max(start, middle.timestamp)),
+            formatTimestamp(std::min(end, bucketEnd(middle.timestamp, bucket))));
+        EXPECT_EQ(middle.count, expected.count);
+        EXPECT_NEAR(middle.values[0], expected.sum[PRODUKCJA], 1e-3);
+        EXPECT_EQ(middle.values[4], expected.max[POBOR]);
+    }
+
+    std::remove(path);
+}
+
+TEST(GroupByTest, BucketBoundariesTest) {
+    // Test granic przedziałów: tygodnie od poniedziałku, miesiące i lata kalendarzowe
+    int64_t timestamp;
+    ASSERT_TRUE(parseTimestamp("01.01.2020 13:37", timestamp));  // Środa
+    EXPECT_EQ(formatTimestamp(bucketStart(timestamp, BUCKET_15_MIN)), "01.01.2020 13:30");
+    EXPECT_EQ(formatTimestamp(bucketStart(timestamp, BUCKET_WEEK)), "30.12.2019 00:00");
+    EXPECT_EQ(formatTimestamp(bucketEnd(bucketStart(timestamp, BUCKET_WEEK), BUCKET_WEEK)), "05.01.2020 23:59");
+    EXPECT_EQ(formatTimestamp(bucketEnd(bucketStart(timestamp, BUCKET_MONTH), BUCKET_MONTH)), "31.01.2020 23:59");
+    ASSERT_TRUE(parseTimestamp("29.02.2020 10:00", timestamp));
+    EXPECT_EQ(formatTimestamp(bucketEnd(bucketStart(timestamp, BUCKET_MONTH), BUCKET_MONTH)), "29.02.2020 23:59");
+    EXPECT_EQ(formatTimestamp(bucketStart(timestamp, BUCKET_YEAR)), "01.01.2020 00:00");
+
+    BucketSize bucket;
+    EXPECT_TRUE(parseBucketSize("week", bucket));
+    EXPECT_EQ(bucket, BUCKET_WEEK);
+    AggregateFunction function;
+    EXPECT_FALSE(parseAggregateFunction("median", function));
+}
+
+TEST_F(TreeDataTest, GroupQueryTest) {
+    // Test polecenia `group` w wykonawcy zapytań
+    treeData.addData(LineData("02.01.2023 06:00", 1.0f, 2.0f, 3.0f, 4.0f, 5.0f));
+
+    QueryExecutor csv(treeData, FORMAT_CSV);
+    std::ostringstream out;
+    csv.execute("group 01.01.2023 00:00 02.01.2023 23:59 day produkcja,pobor sum,count", out);
+    EXPECT_EQ(out.str(),
+        "1,group:sum,01.01.2023 00:00,,,,250,165\n"
+        "1,group:count,01.01.2023 00:00,,,,2,2\n"
+        "1,group:sum,02.01.2023 00:00,,,,4,5\n"
+        "1,group:count,02.01.2023 00:00,,,,1,1\n");
+
+    QueryExecutor json(treeData, FORMAT_JSON);
+    std::ostringstream jsonOut;
+    json.execute("group 01.01.2023 12:45 31.12.2023 23:59 month", jsonOut);
+    EXPECT_EQ(jsonOut.str(), "{\"query\":1,\"command\":\"group\",\"bucket\":\"month\",\"groups\":["
+        "{\"date\":\"01.01.2023 00:00\",\"count\":2,\"sum\":{\"autokonsumpcja\":111,\"eksport\":57,"
+        "\"import\":38,\"pobor\":134,\"produkcja\":90}}]}\n");
+    EXPECT_THROW(json.execute("group 01.01.2023 00:00 02.01.2023 23:59 decade", jsonOut), std::invalid_argument);
+    EXPECT_THROW(json.execute("group 01.01.2023 00:00 02.01.2023 23:59 day produkcja median", jsonOut),
+        std::invalid_argument);
+}
+
+TEST_F(TreeDataTest, CopyOnWriteTest) {
+    // Test zmian w kopii drzewa, które nie mogą być widoczne w oryginale
+    treeData.addData(LineData("15.02.2023 08:00", 7.0f, 7.0f, 7.0f, 7.0f, 7.0f));
+    treeData.buildIndexes();
+
+    TreeData copy(treeData);
+    copy.setDuplicatePolicy(DUPLICATE_REPLACE);
+    copy.addData(LineData("01.01.2023 12:30", 1.0f, 1.0f, 1.0f, 1.0f, 1.0f));
+    copy.addData(LineData("02.01.2023 00:00", 2.0f, 2.0f, 2.0f, 2.0f, 2.0f));
+    copy.addData(LineData("01.01.2024 00:00", 3.0f, 3.0f, 3.0f, 3.0f, 3.0f));
+    copy.buildIndexes();
+
+    EXPECT_EQ(treeData.size(), 3u);
+    EXPECT_DOUBLE_EQ(treeData.aggregateBetweenDates("01.01.2023 00:00", "31.12.2023 23:59").sum[AUTOKONSUMPCJA], 217.0);
+    auto original = treeData.searchRecordsWithTolerance("01.01.2023 00:00", "31.12.2023 23:59", 100.0f, 0.5f);
+    ASSERT_EQ(original.size(), 1u);
+    EXPECT_EQ(original[0].getDate(), "01.01.2023 12:30");
+
+    EXPECT_EQ(copy.size(), 5u);
+    EXPECT_DOUBLE_EQ(copy.aggregateBetweenDates("01.01.2023 00:00", "31.12.2024 23:59").sum[AUTOKONSUMPCJA], 123.0);
+    EXPECT_TRUE(copy.searchRecordsWithTolerance("01.01.2023 00:00", "31.12.2023 23:59", 100.0f, 0.5f).empty());
+
+    // Wyczyszczenie oryginału nie może zwolnić pamięci kolumn współdzielonych z kopią
+    treeData.clear();
+    treeData.addData(LineData("01.03.2023 00:00", 9.0f, 9.0f, 9.0f, 9.0f, 9.0f));
+    auto shared = copy.getDataBetweenDates("15.02.2023 00:00", "15.02.2023 23:59");
+    ASSERT_EQ(shared.size(), 1u);
+    EXPECT_FLOAT_EQ(shared[0].getAutokonsumpcja(), 7.0f);
+}
+
+TEST(TreeStoreTest, ReadersSeeCompleteVersionsTest) {
+    // Test czytelników pracujących równolegle z dopisywaniem kolejnych dni danych minutowych
+    TreeStore store;
+    std::shared_ptr<const TreeData> empty = store.snapshot();
+    const int dayCount = 20;
+    const size_t recordsPerDay = 24 * 60;
+
+    std::atomic<bool> done(false);
+    std::atomic<int> failures(0);
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < 3; ++reader) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                std::shared_ptr<const TreeData> version = store.snapshot();
+                size_t size = version->size();
+                Aggregate aggregate = version->aggregateBetweenDates("01.01.2020 00:00", "31.12.2020 23:59");
+                if (size % recordsPerDay != 0 || aggregate.count != size || version->size() != size) {
+                    ++failures;
+                }
+            }
+        });
+    }
+
+    int64_t start;
+    ASSERT_TRUE(parseTimestamp("30.01.2020 00:00", start));
+    for (int day = 0; day < dayCount; ++day) {
+        store.update([&](TreeData& treeData) {
+            float values[CHANNEL_COUNT] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+            for (size_t minute = 0; minute < recordsPerDay; ++minute) {
+                treeData.addRecord(start + day * static_cast<int64_t>(recordsPerDay) + static_cast<int64_t>(minute), values);
+            }
+            treeData.buildIndexes();
+            return true;
+        });
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(failures, 0);
+    EXPECT_EQ(empty->size(), 0u);
+    EXPECT_EQ(store.getVersion(), static_cast<uint64_t>(dayCount));
+    EXPECT_EQ(store.snapshot()->size(), dayCount * recordsPerDay);
+
+    // Wersja odrzucona przez funkcję zmieniającą nie jest publikowana
+    EXPECT_FALSE(store.update([](TreeData& treeData) {
+        treeData.clear();
+        return false;
+    }));
+    EXPECT_EQ(store.snapshot()->size(), dayCount * recordsPerDay);
+    EXPECT_EQ(store.getVersion(), static_cast<uint64_t>(dayCount));
+}
+
+/**
+ * @brief Wysyła zapytania do serwera i odczytuje tyle odpowiedzi (zakończonych pustym wierszem), ile wysłano wierszy.
+ */
+static std::string askServer(int descriptor, const std::string& requests) {
+    EXPECT_EQ(::send(descriptor, requests.data(), requests.size(), 0), static_cast<ssize_t>(requests.size()));
+    size_t expected = static_cast<size_t>(std::count(requests.begin(), requests.end(), '\n'));
+    std::string response;
+    char buffer[4096];
+    size_t answers = 0;
+    while (answers < expected) {
+        ssize_t received = ::recv(descriptor, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < received; ++i) {
+            response += buffer[i];
+            size_t length = response.size();
+            if (buffer[i] == '\n' && (length == 1 || response[length - 2] == '\n')) {
+                ++answers;
+            }
+        }
+    }
+    return response;
+}
+
+TEST(QueryServerTest, ConcurrentClientsTest) {
+    // Test równoległych klientów TCP i gniazda Unix oraz dopisywania danych w czasie pracy serwera
+    TreeStore store;
+    store.update([](TreeData& treeData) {
+        treeData.addData(LineData("01.01.2023 12:30", 100.0f, 50.0f, 30.0f, 120.0f, 80.0f));
+        treeData.addData(LineData("01.01.2023 13:30", 110.0f, 55.0f, 35.0f, 130.0f, 85.0f));
+        treeData.buildIndexes();
+        return true;
+    });
+
+    QueryServer tcpServer(store, FORMAT_JSON, 4);
+    ASSERT_TRUE(tcpServer.listenTcp(0));
+    ASSERT_NE(tcpServer.getPort(), 0);
+    std::string socketPath = "test_query_server.sock";
+    QueryServer unixServer(store, FORMAT_CSV, 1);
+    ASSERT_TRUE(unixServer.listenUnix(socketPath));
+    std::thread tcpThread([&tcpServer]() { tcpServer.run(); });
+    std::thread unixThread([&unixServer]() { unixServer.run(); });
+
+    std::string sumQuery = "sum 01.01.2023 00:00 01.01.2023 23:59\n";
+    std::string expectedSum = "{\"query\":1,\"command\":\"sum\",\"values\":{\"autokonsumpcja\":210,\"eksport\":105,"
+        "\"import\":65,\"pobor\":250,\"produkcja\":165}}\n\n";
+    std::vector<std::thread> clients;
+    std::atomic<int> mismatches(0);
+    for (int client = 0; client < 6; ++client) {
+        clients.emplace_back([&]() {
+            int descriptor = ::socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(tcpServer.getPort());
+            if (::connect(descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+                || askServer(descriptor, sumQuery) != expectedSum) {
+                ++mismatches;
+            }
+            ::close(descriptor);
+        });
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    EXPECT_EQ(mismatches, 0);
+
+    int descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    socketPath.copy(address.sun_path, socketPath.size());
+    ASSERT_EQ(::connect(descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+    EXPECT_EQ(askServer(descriptor, "search 01.01.2023 00:00 01.01.2023 23:59 autokonsumpcja 100 1\nmedian\n\n"),
+        "1,search,01.01.2023 12:30,100,50,30,120,80\n\n"
+        "2,error,\"Nieznane polecenie: median\"\n\n"
+        "\n");
+
+    // Zapytania wysłane tym samym połączeniem po opublikowaniu nowej wersji widzą nowe rekordy
+    store.update([](TreeData& treeData) {
+        treeData.addData(LineData("01.01.2023 18:00", 100.5f, 1.0f, 1.0f, 1.0f, 1.0f));
+        treeData.buildIndexes();
+        return true;
+    });
+    EXPECT_EQ(askServer(descriptor, "search 01.01.2023 00:00 01.01.2023 23:59 autokonsumpcja 100 1\n"),
+        "3,search,01.01.2023 12:30,100,50,30,120,80\n"
+        "3,search,01.01.2023 18:00,100.5,1,1,1,1\n\n");
+    ::close(descriptor);
+
+    tcpServer.stop();
+    unixServer.stop();
+    tcpThread.join();
+    unixThread.join();
+}
+
+TEST(QueryServerTest, IdleClientsTest) {
+    // Test, czy bezczynne połączenia nie zajmują wątków potrzebnych kolejnym klientom
+    TreeStore store;
+    store.update([](TreeData& treeData) {
+        treeData.addData(LineData("01.01.2023 12:30", 100.0f, 50.0f, 30.0f, 120.0f, 80.0f));
+        treeData.buildIndexes();
+        return true;
+    });
+
+    QueryServer server(store, FORMAT_CSV, 1);
+    ASSERT_TRUE(server.listenTcp(0));
+    std::thread serverThread([&server]() { server.run(); });
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(server.getPort());
+    std::vector<int> descriptors;
+    for (int client = 0; client < 4; ++client) {
+        int descriptor = ::socket(AF_INET, SOCK_STREAM, 0);
+        ASSERT_EQ(::connect(descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+        descriptors.push_back(descriptor);
+    }
+
+    // Ostatni klient dostaje odpowiedź, choć wcześniejsze połączenia są otwarte i nic nie wysłały
+    EXPECT_EQ(askServer(descriptors.back(), "sum 01.01.2023 00:00 01.01.2023 23:59\n"),
+        "1,sum,,100,50,30,120,80\n\n");
+    EXPECT_EQ(askServer(descriptors.front(), "sum 01.01.2023 00:00 01.01.2023 23:59\n"),
+        "1,sum,,100,50,30,120,80\n\n");
+
+    for (int descriptor : descriptors) {
+        ::close(descriptor);
+    }
+    server.stop();
+    serverThread.join();
+}
+
+TEST(ParallelQueryTest, MatchesSerialOrderTest) {
+    // Test zapytań dzielonych na miesiące między wątki względem przejścia jednym wątkiem
+    GeneratorOptions options;
+    options.recordCount = 150000;
+    options.interval = 5;
+    options.gapRate = 0.001;
+    TreeData treeData;
+    DataGenerator(options).fill(treeData);
+    treeData.buildIndexes();
+
+    std::string from = "17.01.2020 13:07";
+    std::string to = "03.02.2021 08:55";
+    auto expectSame = [](const std::vector<LineData>& parallel, const std::vector<LineData>& serial) {
+        ASSERT_EQ(parallel.size(), serial.size());
+        for (size_t i = 0; i < serial.size(); ++i) {
+            ASSERT_EQ(parallel[i].getDate(), serial[i].getDate());
+            for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                ASSERT_EQ(parallel[i].getValue(static_cast<Channel>(channel)), serial[i].getValue(static_cast<Channel>(channel)));
+            }
+        }
+    };
+
+    std::vector<LineData> serial;
+    treeData.forEachBetweenDates(from, to, [&serial](const RecordView& record) { serial.push_back(record.toLineData()); });
+    ASSERT_GT(serial.size(), 100000u);
+    expectSame(treeData.getDataBetweenDates(from, to), serial);
+    size_t rangeSize = serial.size();
+
+    Predicate predicate = Predicate::greater(PRODUKCJA, 0.3f) || Predicate::less(POBOR, 0.035f);
+    serial.clear();
+    treeData.forEachBetweenDates(from, to, predicate, [&serial](const RecordView& record) { serial.push_back(record.toLineData()); });
+    ASSERT_FALSE(serial.empty());
+    expectSame(treeData.getDataBetweenDates(from, to, predicate), serial);
+
+    serial.clear();
+    treeData.forEachWithTolerance(from, to, 0.05f, 0.01f, POBOR, [&serial](const RecordView& record) { serial.push_back(record.toLineData()); });
+    ASSERT_FALSE(serial.empty());
+    expectSame(treeData.searchRecordsWithTolerance(from, to, 0.05f, 0.01f, POBOR), serial);
+
+    EXPECT_TRUE(treeData.getDataBetweenDates("01.01.2021 00:00", "31.12.2020 23:59").empty());
+    EXPECT_TRUE(treeData.searchRecordsWithTolerance("bad", to, 0.5f, 0.05f, POBOR).empty());
+
+    // Zagnieżdżone pętle z wątków wspólnej puli nie mogą się zablokować
+    std::vector<size_t> counts(8);
+    ThreadPool::shared().forEachIndex(counts.size(), [&](size_t index) {
+        counts[index] = treeData.getDataBetweenDates(from, to).size();
+    });
+    for (size_t count : counts) {
+        EXPECT_EQ(count, rangeSize);
+    }
+}
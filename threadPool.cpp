@@ -0,0 +1,71 @@
+/**
+ * @file threadPool.cpp
+ * @brief Implementacja klasy `ThreadPool`.
+ */
+
+#include "threadPool.hpp"
+
+/**
+ * @brief Tworzy pulę z podaną liczbą wątków.
+ * @param threadCount Liczba wątków (0 oznacza liczbę rdzeni procesora).
+ */
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = defaultThreadCount();
+    }
+
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * @brief Czeka na wykonanie zleconych zadań i zatrzymuje wątki.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Zwraca domyślną liczbę wątków (liczbę rdzeni, co najmniej 1).
+ */
+size_t ThreadPool::defaultThreadCount() {
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores > 0 ? cores : 1;
+}
+
+/**
+ * @brief Zwraca wspólną pulę programu.
+ */
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(defaultThreadCount());
+    return pool;
+}
+
+/**
+ * @brief Pętla wątku roboczego: pobiera i wykonuje zadania aż do zatrzymania puli.
+ */
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
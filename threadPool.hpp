@@ -0,0 +1,165 @@
+/**
+ * @file threadPool.hpp
+ * @brief Deklaracja klasy `ThreadPool` wykonującej zadania na stałej puli wątków.
+ */
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Stała pula wątków roboczych pobierających zadania ze wspólnej kolejki.
+ *
+ * Zadania są zlecane przez `submit`, który zwraca `std::future` z wynikiem zadania.
+ * Destruktor kończy pracę wątków po wykonaniu wszystkich zleconych zadań.
+ *
+ * `forEachIndex` dzieli pętlę na zadania pobierane dynamicznie przez wątek wywołujący i wolne wątki puli,
+ * więc nierówne zadania same się równoważą, a pula wspólna (`shared`) może być używana także z jej wątków.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Tworzy pulę z podaną liczbą wątków.
+     * @param threadCount Liczba wątków (0 oznacza liczbę rdzeni procesora).
+     */
+    explicit ThreadPool(size_t threadCount);
+
+    /**
+     * @brief Czeka na wykonanie zleconych zadań i zatrzymuje wątki.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Zleca zadanie do wykonania w puli.
+     * @param task Funkcja bez argumentów.
+     * @return Przyszły wynik zadania.
+     */
+    template <typename Task>
+    auto submit(Task&& task) -> std::future<decltype(task())>;
+
+    /**
+     * @brief Wykonuje `task(i)` dla każdego `i` z [0, count) i czeka na zakończenie wszystkich wywołań.
+     *
+     * Wątek wywołujący sam wykonuje zadania, a wolne wątki puli pobierają kolejne indeksy ze wspólnego
+     * licznika. Funkcja nie czeka na wątki, które nie zdążyły pobrać żadnego indeksu, więc nie blokuje się,
+     * gdy wszystkie wątki puli są zajęte. Pierwszy wyjątek zgłoszony przez zadanie jest przekazywany dalej.
+     *
+     * @param count Liczba zadań.
+     * @param task Funkcja `void(size_t)`.
+     */
+    template <typename Task>
+    void forEachIndex(size_t count, Task&& task);
+
+    /**
+     * @brief Zwraca liczbę wątków w puli.
+     */
+    size_t size() const { return workers.size(); }
+
+    /**
+     * @brief Zwraca domyślną liczbę wątków (liczbę rdzeni, co najmniej 1).
+     */
+    static size_t defaultThreadCount();
+
+    /**
+     * @brief Zwraca wspólną pulę programu (`defaultThreadCount` wątków) do równoległego wykonywania zapytań.
+     */
+    static ThreadPool& shared();
+
+private:
+    /**
+     * @brief Pętla wątku roboczego.
+     */
+    void workerLoop();
+
+    std::vector<std::thread> workers; /**< Wątki robocze. */
+    std::queue<std::function<void()>> tasks; /**< Kolejka zleconych zadań. */
+    std::mutex mutex; /**< Chroni kolejkę zadań. */
+    std::condition_variable condition; /**< Sygnalizuje nowe zadania i zatrzymanie. */
+    bool stopping = false; /**< Czy pula jest zatrzymywana. */
+};
+
+template <typename Task>
+auto ThreadPool::submit(Task&& task) -> std::future<decltype(task())> {
+    using Result = decltype(task());
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+    std::future<Result> result = packaged->get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.emplace([packaged]() { (*packaged)(); });
+    }
+    condition.notify_one();
+
+    return result;
+}
+
+template <typename Task>
+void ThreadPool::forEachIndex(size_t count, Task&& task) {
+    // Stan pętli współdzielony z zadaniami puli, które mogą ruszyć już po jej zakończeniu
+    struct Loop {
+        std::atomic<size_t> next{ 0 };
+        size_t done = 0;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto loop = std::make_shared<Loop>();
+
+    // Spóźnione zadanie nie pobierze już indeksu, więc nie odwołuje się do `task` po powrocie z funkcji
+    auto drain = [loop, count, &task]() {
+        size_t processed = 0;
+        for (size_t index = loop->next++; index < count; index = loop->next++) {
+            try {
+                task(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(loop->mutex);
+                if (!loop->error) {
+                    loop->error = std::current_exception();
+                }
+            }
+            ++processed;
+        }
+        if (processed > 0) {
+            std::lock_guard<std::mutex> lock(loop->mutex);
+            loop->done += processed;
+            if (loop->done == count) {
+                loop->finished.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = count > 1 ? std::min(workers.size(), count - 1) : 0;
+    if (helpers > 0) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < helpers; ++i) {
+                tasks.emplace(drain);
+            }
+        }
+        condition.notify_all();
+    }
+    drain();
+
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->finished.wait(lock, [&loop, count]() { return loop->done == count; });
+    if (loop->error) {
+        std::rethrow_exception(loop->error);
+    }
+}
+
+#endif
@@ -0,0 +1,306 @@
+/**
+ * @file timeSeriesCodec.cpp
+ * @brief Implementacja kodowania delta-of-delta i XOR kolumn szeregów czasowych.
+ */
+
+#include <cstring>
+#include <stdexcept>
+
+#include "timeSeriesCodec.hpp"
+
+/**
+ * @class BitWriter
+ * @brief Zapisuje ciąg bitów (od najstarszego) do bufora bajtów.
+ */
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    /**
+     * @brief Zapisuje `count` najmłodszych bitów wartości (`count` <= 64).
+     */
+    void write(uint64_t value, int count) {
+        if (count > 32) {
+            write(value >> 32, count - 32);
+            count = 32;
+        }
+        if (count == 0) {
+            return;
+        }
+
+        buffer = (buffer << count) | (value & ((uint64_t(1) << count) - 1));
+        bits += count;
+        while (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<uint8_t>(buffer >> bits));
+        }
+        buffer &= (uint64_t(1) << bits) - 1;
+    }
+
+    /**
+     * @brief Zapisuje niepełny ostatni bajt dopełniony zerami.
+     */
+    void finish() {
+        if (bits > 0) {
+            out.push_back(static_cast<uint8_t>(buffer << (8 - bits)));
+            buffer = 0;
+            bits = 0;
+        }
+    }
+
+private:
+    std::vector<uint8_t>& out; /**< Bufor wyjściowy. */
+    uint64_t buffer = 0; /**< Bity oczekujące na zapis. */
+    int bits = 0; /**< Liczba oczekujących bitów (< 8 pomiędzy wywołaniami). */
+};
+
+/**
+ * @class BitReader
+ * @brief Odczytuje ciąg bitów (od najstarszego) z bufora bajtów.
+ */
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    /**
+     * @brief Odczytuje `count` bitów (`count` <= 64).
+     * @throws std::runtime_error Jeśli dane się skończyły.
+     */
+    uint64_t read(int count) {
+        if (count > 32) {
+            uint64_t high = read(count - 32);
+            return (high << 32) | read(32);
+        }
+
+        while (bits < count) {
+            if (position == size) {
+                throw std::runtime_error("Nieoczekiwany koniec skompresowanego bloku");
+            }
+            buffer = (buffer << 8) | data[position++];
+            bits += 8;
+        }
+
+        bits -= count;
+        uint64_t value = (buffer >> bits) & ((uint64_t(1) << count) - 1);
+        buffer &= (uint64_t(1) << bits) - 1;
+        return value;
+    }
+
+    /**
+     * @brief Odczytuje pojedynczy bit.
+     */
+    bool readBit() { return read(1) != 0; }
+
+private:
+    const uint8_t* data; /**< Dane wejściowe. */
+    size_t size; /**< Rozmiar danych wejściowych. */
+    size_t position = 0; /**< Pozycja następnego bajtu do wczytania. */
+    uint64_t buffer = 0; /**< Wczytane, nieodczytane bity. */
+    int bits = 0; /**< Liczba wczytanych, nieodczytanych bitów. */
+};
+
+/**
+ * @brief Przekształca liczbę ze znakiem tak, by małe wartości bezwzględne miały mało bitów.
+ */
+static uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+/**
+ * @brief Odwraca `zigzagEncode`.
+ */
+static int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * @brief Zwraca liczbę zer wiodących 32-bitowej wartości różnej od zera.
+ */
+static int leadingZeros(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clz(value);
+#else
+    int count = 0;
+    while (!(value & 0x80000000u)) {
+        value <<= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Zwraca liczbę zer końcowych 32-bitowej wartości różnej od zera.
+ */
+static int trailingZeros(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(value);
+#else
+    int count = 0;
+    while (!(value & 1u)) {
+        value >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Koduje kolumnę znaczników czasu metodą delta-of-delta.
+ */
+void TimeSeriesCodec::encodeTimestamps(const int64_t* values, size_t count, std::vector<uint8_t>& out) {
+    if (count == 0) {
+        return;
+    }
+
+    BitWriter writer(out);
+    writer.write(static_cast<uint64_t>(values[0]), 64);
+
+    int64_t previousDelta = 0;
+    for (size_t i = 1; i < count; ++i) {
+        int64_t delta = values[i] - values[i - 1];
+        uint64_t encoded = zigzagEncode(delta - previousDelta);
+        previousDelta = delta;
+
+        if (encoded == 0) {
+            writer.write(0, 1);
+        } else if (encoded < (1u << 7)) {
+            writer.write(0x2, 2);
+            writer.write(encoded, 7);
+        } else if (encoded < (1u << 9)) {
+            writer.write(0x6, 3);
+            writer.write(encoded, 9);
+        } else if (encoded < (1u << 12)) {
+            writer.write(0xE, 4);
+            writer.write(encoded, 12);
+        } else {
+            writer.write(0xF, 4);
+            writer.write(encoded, 64);
+        }
+    }
+
+    writer.finish();
+}
+
+/**
+ * @brief Dekoduje kolumnę znaczników czasu.
+ */
+void TimeSeriesCodec::decodeTimestamps(const uint8_t* data, size_t size, int64_t* values, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    BitReader reader(data, size);
+    values[0] = static_cast<int64_t>(reader.read(64));
+
+    int64_t delta = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (reader.readBit()) {
+            int width;
+            if (!reader.readBit()) {
+                width = 7;
+            } else if (!reader.readBit()) {
+                width = 9;
+            } else if (!reader.readBit()) {
+                width = 12;
+            } else {
+                width = 64;
+            }
+            delta += zigzagDecode(reader.read(width));
+        }
+        values[i] = values[i - 1] + delta;
+    }
+}
+
+/**
+ * @brief Koduje kolumnę wartości metodą XOR.
+ */
+void TimeSeriesCodec::encodeFloats(const float* values, size_t count, std::vector<uint8_t>& out) {
+    if (count == 0) {
+        return;
+    }
+
+    BitWriter writer(out);
+    uint32_t previous;
+    std::memcpy(&previous, &values[0], sizeof(previous));
+    writer.write(previous, 32);
+
+    int windowLeading = -1;
+    int windowLength = 0;
+    for (size_t i = 1; i < count; ++i) {
+        uint32_t current;
+        std::memcpy(&current, &values[i], sizeof(current));
+        uint32_t difference = current ^ previous;
+        previous = current;
+
+        if (difference == 0) {
+            writer.write(0, 1);
+            continue;
+        }
+
+        int leading = leadingZeros(difference);
+        int trailing = trailingZeros(difference);
+        if (windowLeading >= 0 && leading >= windowLeading && trailing >= 32 - windowLeading - windowLength) {
+            writer.write(0x2, 2);
+            writer.write(difference >> (32 - windowLeading - windowLength), windowLength);
+        } else {
+            windowLeading = leading;
+            windowLength = 32 - leading - trailing;
+            writer.write(0x3, 2);
+            writer.write(static_cast<uint64_t>(windowLeading), 5);
+            writer.write(static_cast<uint64_t>(windowLength - 1), 5);
+            writer.write(difference >> trailing, windowLength);
+        }
+    }
+
+    writer.finish();
+}
+
+/**
+ * @brief Dekoduje kolumnę wartości.
+ */
+void TimeSeriesCodec::decodeFloats(const uint8_t* data, size_t size, float* values, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    BitReader reader(data, size);
+    uint32_t previous = static_cast<uint32_t>(reader.read(32));
+    std::memcpy(&values[0], &previous, sizeof(previous));
+
+    int windowLeading = -1;
+    int windowLength = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (reader.readBit()) {
+            if (reader.readBit()) {
+                windowLeading = static_cast<int>(reader.read(5));
+                windowLength = static_cast<int>(reader.read(5)) + 1;
+                if (windowLeading + windowLength > 32) {
+                    throw std::runtime_error("Niepoprawne okno w skompresowanym bloku");
+                }
+            } else if (windowLeading < 0) {
+                throw std::runtime_error("Niepoprawne okno w skompresowanym bloku");
+            }
+
+            uint32_t difference = static_cast<uint32_t>(reader.read(windowLength));
+            previous ^= difference << (32 - windowLeading - windowLength);
+        }
+        std::memcpy(&values[i], &previous, sizeof(previous));
+    }
+}
+
+/**
+ * @brief Zwraca największy możliwy rozmiar zakodowanej kolumny znaczników czasu.
+ */
+size_t TimeSeriesCodec::maxTimestampsSize(size_t count) {
+    // Pierwsza wartość na 64 bitach, kolejne najwyżej `1111` + 64 bity
+    return count == 0 ? 0 : (64 + (count - 1) * 68 + 7) / 8;
+}
+
+/**
+ * @brief Zwraca największy możliwy rozmiar zakodowanej kolumny wartości.
+ */
+size_t TimeSeriesCodec::maxFloatsSize(size_t count) {
+    // Pierwsza wartość na 32 bitach, kolejne najwyżej `11` + 5 + 5 + 32 bity
+    return count == 0 ? 0 : (32 + (count - 1) * 44 + 7) / 8;
+}
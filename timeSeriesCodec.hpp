@@ -0,0 +1,90 @@
+/**
+ * @file timeSeriesCodec.hpp
+ * @brief Deklaracja klasy `TimeSeriesCodec` kompresującej kolumny szeregów czasowych.
+ *
+ * ## Kodowanie znaczników czasu (delta-of-delta):
+ * Pierwsza wartość zapisywana jest na 64 bitach. Dla kolejnych zapisywana jest różnica
+ * pomiędzy bieżącym a poprzednim przyrostem (dla pomiarów co stały interwał równa 0),
+ * zakodowana zigzag w jednym z przedziałów:
+ * - `0` - różnica równa 0 (1 bit),
+ * - `10` + 7 bitów, `110` + 9 bitów, `1110` + 12 bitów,
+ * - `1111` + 64 bity - dowolna wartość.
+ *
+ * ## Kodowanie wartości (XOR, jak w bazie Gorilla):
+ * Pierwsza wartość zapisywana jest na 32 bitach. Dla kolejnych zapisywany jest XOR z poprzednią:
+ * - `0` - wartość bez zmian (1 bit),
+ * - `10` + znaczące bity - znaczące bity mieszczą się w poprzednim oknie,
+ * - `11` + 5 bitów zer wiodących + 5 bitów (długość - 1) + znaczące bity - nowe okno.
+ *
+ * Bity zapisywane są od najstarszego, a ostatni bajt dopełniany jest zerami.
+ */
+
+#ifndef TIMESERIESCODEC_HPP
+#define TIMESERIESCODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class TimeSeriesCodec
+ * @brief Klasa narzędziowa kodująca kolumny znaczników czasu i wartości kanałów.
+ */
+class TimeSeriesCodec {
+public:
+    TimeSeriesCodec() = delete;
+    TimeSeriesCodec(const TimeSeriesCodec&) = delete;
+    TimeSeriesCodec& operator=(const TimeSeriesCodec&) = delete;
+
+    /**
+     * @brief Koduje kolumnę znaczników czasu metodą delta-of-delta.
+     * @param values Znaczniki czasu.
+     * @param count Liczba wartości.
+     * @param out Bufor, do którego dopisywane są zakodowane bajty.
+     */
+    static void encodeTimestamps(const int64_t* values, size_t count, std::vector<uint8_t>& out);
+
+    /**
+     * @brief Dekoduje kolumnę znaczników czasu.
+     * @param data Zakodowane bajty.
+     * @param size Liczba zakodowanych bajtów.
+     * @param values Bufor wynikowy na `count` wartości.
+     * @param count Liczba wartości do zdekodowania.
+     * @throws std::runtime_error Jeśli dane są uszkodzone lub za krótkie.
+     */
+    static void decodeTimestamps(const uint8_t* data, size_t size, int64_t* values, size_t count);
+
+    /**
+     * @brief Koduje kolumnę wartości metodą XOR.
+     * @param values Wartości.
+     * @param count Liczba wartości.
+     * @param out Bufor, do którego dopisywane są zakodowane bajty.
+     */
+    static void encodeFloats(const float* values, size_t count, std::vector<uint8_t>& out);
+
+    /**
+     * @brief Dekoduje kolumnę wartości.
+     * @param data Zakodowane bajty.
+     * @param size Liczba zakodowanych bajtów.
+     * @param values Bufor wynikowy na `count` wartości.
+     * @param count Liczba wartości do zdekodowania.
+     * @throws std::runtime_error Jeśli dane są uszkodzone lub za krótkie.
+     */
+    static void decodeFloats(const uint8_t* data, size_t size, float* values, size_t count);
+
+    /**
+     * @brief Zwraca największy możliwy rozmiar zakodowanej kolumny znaczników czasu.
+     * @param count Liczba wartości.
+     * @return Liczba bajtów dla `count` wartości zakodowanych najdłuższymi kodami.
+     */
+    static size_t maxTimestampsSize(size_t count);
+
+    /**
+     * @brief Zwraca największy możliwy rozmiar zakodowanej kolumny wartości.
+     * @param count Liczba wartości.
+     * @return Liczba bajtów dla `count` wartości zakodowanych najdłuższymi kodami.
+     */
+    static size_t maxFloatsSize(size_t count);
+};
+
+#endif
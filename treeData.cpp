@@ -1,156 +1,601 @@
+#include <atomic>
 #include <iostream>
+#include <iterator>
 #include <sstream>
-#include <iomanip>
-#include <ctime>
 
+#include "dateTime.hpp"
+#include "logger.hpp"
+#include "snapshot.hpp"
+#include "threadPool.hpp"
 #include "treeData.hpp"
 
 using namespace std;
 
+/**
+ * @brief Największy blok obsługiwany przez pulę areny.
+ *
+ * Mieści kolumny kwartału z danymi minutowymi; większe bloki trafiają wprost do bufora monotonicznego.
+ */
+static const size_t ARENA_LARGEST_POOL_BLOCK = 64 * 1024;
+
+/**
+ * @brief Rozmiar pierwszego fragmentu bufora monotonicznego (kolejne rosną geometrycznie).
+ */
+static const size_t ARENA_INITIAL_SIZE = 256 * 1024;
+
+/**
+ * @brief Najmniejsza liczba rekordów w miesiącach przedziału, od której zapytania zbierające rekordy są zrównoleglane.
+ *
+ * Mniejsze przedziały przegląda się szybciej, niż trwa rozdzielenie ich między wątki.
+ */
+static const size_t PARALLEL_MIN_RECORDS = 50000;
+
+/**
+ * @brief Zwraca ustawienia puli areny.
+ */
+static std::pmr::pool_options arenaPoolOptions() {
+    std::pmr::pool_options options;
+    options.largest_required_pool_block = ARENA_LARGEST_POOL_BLOCK;
+    return options;
+}
+
+TreeData::Arena::Arena() : buffer(ARENA_INITIAL_SIZE), pool(arenaPoolOptions(), &buffer) {}
+
+/**
+ * @brief Sprawdza, czy węzeł należy wyłącznie do bieżącej kopii drzewa i można go zmieniać w miejscu.
+ *
+ * Bariera synchronizuje się ze zwolnieniem referencji przez wątek, który ostatnio czytał węzeł.
+ */
+template <typename Node>
+static bool isExclusive(const std::shared_ptr<Node>& node) {
+    if (node.use_count() != 1) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+}
+
+TreeData::TreeData() : arena(std::make_shared<Arena>()) {}
+
+TreeData& TreeData::operator=(const TreeData& other) {
+    if (this != &other) {
+        years.clear();
+        arena = other.arena;
+        years = other.years;
+        firstYear = other.firstYear;
+        duplicatePolicy = other.duplicatePolicy;
+        duplicateCount = other.duplicateCount;
+    }
+    return *this;
+}
+
+TreeData& TreeData::operator=(TreeData&& other) noexcept {
+    if (this != &other) {
+        years.clear();
+        arena = std::move(other.arena);
+        years = std::move(other.years);
+        firstYear = other.firstYear;
+        duplicatePolicy = other.duplicatePolicy;
+        duplicateCount = other.duplicateCount;
+    }
+    return *this;
+}
+
+void TreeData::QuarterNode::bind(std::pmr::memory_resource* resource) {
+    timestamps = std::pmr::vector<int64_t>(resource);
+    hours = std::pmr::vector<Aggregate>(6, Aggregate(), resource);
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        channels[channel] = std::pmr::vector<float>(resource);
+        valueIndex[channel] = std::pmr::vector<uint32_t>(resource);
+    }
+}
+
+void TreeData::QuarterNode::assign(const QuarterNode& other) {
+    quarter = other.quarter;
+    hour = other.hour;
+    minute = other.minute;
+    timestamps.assign(other.timestamps.begin(), other.timestamps.end());
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        channels[channel].assign(other.channels[channel].begin(), other.channels[channel].end());
+        valueIndex[channel].assign(other.valueIndex[channel].begin(), other.valueIndex[channel].end());
+    }
+    aggregate = other.aggregate;
+    hours.assign(other.hours.begin(), other.hours.end());
+    indexed = other.indexed;
+}
+
+void TreeData::QuarterNode::append(int64_t timestamp, const float values[CHANNEL_COUNT]) {
+    if (timestamps.empty() || timestamps.back() <= timestamp) {
+        timestamps.push_back(timestamp);
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            channels[channel].push_back(values[channel]);
+        }
+    } else {
+        size_t position = std::upper_bound(timestamps.begin(), timestamps.end(), timestamp) - timestamps.begin();
+        timestamps.insert(timestamps.begin() + position, timestamp);
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            channels[channel].insert(channels[channel].begin() + position, values[channel]);
+        }
+    }
+    aggregate.add(values);
+    hours[hourSlot(timestamp)].add(values);
+    indexed = false;
+}
+
+Aggregate TreeData::QuarterNode::addHours(const int64_t* timestamps, const float* const channels[CHANNEL_COUNT],
+    size_t begin, size_t end) {
+    Aggregate total;
+    while (begin < end) {
+        size_t slot = hourSlot(timestamps[begin]);
+        size_t hourEnd = begin + 1;
+        while (hourEnd < end && hourSlot(timestamps[hourEnd]) == slot) {
+            ++hourEnd;
+        }
+        Aggregate hour;
+        hour.addColumns(channels, begin, hourEnd);
+        hours[slot].merge(hour);
+        total.merge(hour);
+        begin = hourEnd;
+    }
+    return total;
+}
+
+void TreeData::QuarterNode::rebuildAggregates() {
+    const float* columns[CHANNEL_COUNT];
+    getColumns(columns);
+    std::fill(hours.begin(), hours.end(), Aggregate());
+    aggregate = addHours(timestamps.data(), columns, 0, size());
+}
+
+LineData TreeData::QuarterNode::getRecord(size_t index) const {
+    return LineData(timestamps[index],
+        channels[AUTOKONSUMPCJA][index], channels[EKSPORT][index], channels[IMPORT][index],
+        channels[POBOR][index], channels[PRODUKCJA][index]);
+}
+
+void TreeData::QuarterNode::getColumns(const float* columns[CHANNEL_COUNT]) const {
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        columns[channel] = channels[channel].data();
+    }
+}
+
+void TreeData::QuarterNode::buildIndex() {
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        const std::pmr::vector<float>& values = channels[channel];
+        std::pmr::vector<uint32_t>& index = valueIndex[channel];
+        index.resize(values.size());
+        for (size_t i = 0; i < index.size(); ++i) {
+            index[i] = static_cast<uint32_t>(i);
+        }
+        std::stable_sort(index.begin(), index.end(),
+            [&values](uint32_t a, uint32_t b) { return values[a] < values[b]; });
+    }
+    indexed = true;
+}
+
+void TreeData::QuarterNode::findValues(Channel channel, float low, float high, size_t begin, size_t end,
+    std::vector<uint32_t>& positions) const {
+    const std::pmr::vector<float>& values = channels[channel];
+    size_t first = positions.size();
+
+    if (indexed) {
+        const std::pmr::vector<uint32_t>& index = valueIndex[channel];
+        auto it = std::lower_bound(index.begin(), index.end(), low,
+            [&values](uint32_t position, float value) { return values[position] < value; });
+        for (; it != index.end() && values[*it] <= high; ++it) {
+            if (*it >= begin && *it < end) {
+                positions.push_back(*it);
+            }
+        }
+        std::sort(positions.begin() + first, positions.end());
+    } else {
+        for (size_t i = begin; i < end; ++i) {
+            if (values[i] >= low && values[i] <= high) {
+                positions.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+}
+
 void TreeData::addData(const LineData& lineData) {
-    stringstream ss(lineData.getDate());
-    string token;
-    vector<int> dateParts;
+    int64_t timestamp = lineData.getTimestamp();
+    if (timestamp == INVALID_TIMESTAMP) {
+        return;
+    }
 
-    while (getline(ss, token, '.')) {
-        dateParts.push_back(stoi(token));
+    float values[CHANNEL_COUNT];
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        values[channel] = lineData.getValue(static_cast<Channel>(channel));
     }
+    addRecord(timestamp, values);
+}
 
-    int year = dateParts[2];
-    int month = dateParts[1];
-    int day = dateParts[0];
-    int hour = stoi(lineData.getDate().substr(11, 2));
-    int minute = stoi(lineData.getDate().substr(14, 2));
+void TreeData::addRecord(int64_t timestamp, const float values[CHANNEL_COUNT]) {
+    int year, month, day, hour, minute;
+    splitTimestamp(timestamp, year, month, day, hour, minute);
     int quarter = (hour * 60 + minute) / 360;
 
-    years[year].year = year;
-    years[year].months[month].month = month;
-    years[year].months[month].days[day].day = day;
-    years[year].months[month].days[day].quarters[quarter].quarter = quarter;
-    years[year].months[month].days[day].quarters[quarter].hour = hour;
-    years[year].months[month].days[day].quarters[quarter].minute = minute;
-    years[year].months[month].days[day].quarters[quarter].data.push_back(lineData);
+    YearNode& yearNode = yearAt(year);
+    MonthNode& monthNode = monthAt(yearNode, month);
+    DayNode& dayNode = monthNode.days[day];
+    dayNode.day = day;
+    QuarterNode& quarterNode = quarterAt(dayNode, quarter);
+    quarterNode.quarter = quarter;
+    quarterNode.hour = hour;
+    quarterNode.minute = minute;
+
+    int minuteOfDay = hour * 60 + minute;
+    if (dayNode.minutes.test(minuteOfDay)
+        && !handleDuplicate(yearNode, monthNode, dayNode, quarterNode, timestamp, values)) {
+        return;
+    }
+    dayNode.minutes.set(minuteOfDay);
+
+    yearNode.aggregate.add(values);
+    monthNode.aggregate.add(values);
+    dayNode.aggregate.add(values);
+    quarterNode.append(timestamp, values);
 }
 
-void TreeData::print() const {
-    for (const auto& yearPair : years) {
-        const YearNode& yearNode = yearPair.second;
-        cout << "Year: " << yearNode.year << endl;
+TreeData::YearNode& TreeData::yearAt(int year) {
+    if (years.empty()) {
+        firstYear = year;
+    } else if (year < firstYear) {
+        size_t shift = static_cast<size_t>(firstYear - year);
+        std::vector<std::shared_ptr<YearNode>> grown(years.size() + shift);
+        std::move(years.begin(), years.end(), grown.begin() + shift);
+        years.swap(grown);
+        firstYear = year;
+    }
+    size_t index = static_cast<size_t>(year - firstYear);
+    if (index >= years.size()) {
+        years.resize(index + 1);
+    }
 
-        for (const auto& monthPair : yearNode.months) {
-            const MonthNode& monthNode = monthPair.second;
-            cout << "\tMonth: " << monthNode.month << endl;
+    std::shared_ptr<YearNode>& yearNode = years[index];
+    if (!yearNode) {
+        yearNode = std::make_shared<YearNode>();
+        yearNode->year = year;
+    } else if (!isExclusive(yearNode)) {
+        // Kopia roku współdzieli miesiące; kopiowany jest dopiero zmieniany miesiąc (monthAt)
+        yearNode = std::make_shared<YearNode>(*yearNode);
+    }
+    return *yearNode;
+}
 
-            for (const auto& dayPair : monthNode.days) {
-                const DayNode& dayNode = dayPair.second;
-                cout << "\t\tDay: " << dayNode.day << endl;
+TreeData::MonthNode& TreeData::monthAt(YearNode& yearNode, int month) {
+    std::shared_ptr<MonthNode>& monthNode = yearNode.months[month];
+    if (!monthNode) {
+        monthNode = std::make_shared<MonthNode>();
+        monthNode->month = month;
+    } else if (!isExclusive(monthNode)) {
+        const MonthNode& shared = *monthNode;
+        auto copy = std::make_shared<MonthNode>();
+        copy->month = shared.month;
+        copy->aggregate = shared.aggregate;
+        for (const DayNode& sharedDay : shared.days) {
+            DayNode& dayNode = copy->days[sharedDay.day];
+            dayNode.day = sharedDay.day;
+            dayNode.aggregate = sharedDay.aggregate;
+            dayNode.minutes = sharedDay.minutes;
+            for (const QuarterNode& sharedQuarter : sharedDay.quarters) {
+                quarterAt(dayNode, sharedQuarter.quarter).assign(sharedQuarter);
+            }
+        }
+        monthNode = std::move(copy);
+    }
+    return *monthNode;
+}
 
-                for (const auto& quarterPair : dayNode.quarters) {
-                    const QuarterNode& quarterNode = quarterPair.second;
-                    cout << "\t\t\tQuarter: " << quarterNode.quarter
-                        << " (Hour: " << quarterNode.hour << ", Minute: " << quarterNode.minute << ")" << endl;
+TreeData::QuarterNode& TreeData::quarterAt(DayNode& dayNode, int quarter) {
+    if (dayNode.quarters.contains(quarter)) {
+        return dayNode.quarters[quarter];
+    }
+    if (!arena) {
+        arena = std::make_shared<Arena>();
+    }
+    QuarterNode& quarterNode = dayNode.quarters[quarter];
+    quarterNode.bind(&arena->pool);
+    return quarterNode;
+}
+
+const TreeData::YearNode* TreeData::findYear(int year) const {
+    if (year < firstYear || year - firstYear >= static_cast<int>(years.size())) {
+        return nullptr;
+    }
+    return years[year - firstYear].get();
+}
+
+bool TreeData::handleDuplicate(YearNode& yearNode, MonthNode& monthNode, DayNode& dayNode, QuarterNode& quarterNode,
+    int64_t timestamp, const float values[CHANNEL_COUNT]) {
+    ++duplicateCount;
+    if (duplicatePolicy == DUPLICATE_KEEP) {
+        return true;
+    }
+
+    size_t position = std::lower_bound(quarterNode.timestamps.begin(), quarterNode.timestamps.end(), timestamp)
+        - quarterNode.timestamps.begin();
+    bool equal = true;
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        equal = equal && quarterNode.channels[channel][position] == values[channel];
+    }
+
+    if (duplicatePolicy == DUPLICATE_FLAG && !equal) {
+        std::ostringstream message;
+        message << "Zduplikowany rekord " << formatTimestamp(timestamp) << ":";
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            message << " " << values[channel];
+        }
+        message << " (pozostawiono:";
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            message << " " << quarterNode.channels[channel][position];
+        }
+        message << ")";
+        loggerError.log(message.str());
+    } else if (duplicatePolicy == DUPLICATE_REPLACE && !equal) {
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            quarterNode.channels[channel][position] = values[channel];
+        }
+        quarterNode.indexed = false;
+
+        // Minimów i maksimów nie da się zaktualizować przyrostowo, więc agregaty liczone są od nowa
+        quarterNode.rebuildAggregates();
+        dayNode.aggregate = Aggregate();
+        for (const QuarterNode& node : dayNode.quarters) {
+            dayNode.aggregate.merge(node.aggregate);
+        }
+        monthNode.aggregate = Aggregate();
+        for (const DayNode& node : monthNode.days) {
+            monthNode.aggregate.merge(node.aggregate);
+        }
+        yearNode.aggregate = Aggregate();
+        for (const auto& node : yearNode.months) {
+            yearNode.aggregate.merge(node->aggregate);
+        }
+    }
+    return false;
+}
+
+void TreeData::merge(TreeData&& other) {
+    duplicateCount += other.duplicateCount;
+
+    for (auto& otherYearSlot : other.years) {
+        if (!otherYearSlot) {
+            continue;
+        }
+        const YearNode& otherYear = *otherYearSlot;
+        YearNode& yearNode = yearAt(otherYear.year);
+
+        for (const auto& otherMonthSlot : otherYear.months) {
+            const MonthNode& otherMonth = *otherMonthSlot;
+            MonthNode& monthNode = monthAt(yearNode, otherMonth.month);
+
+            for (const DayNode& otherDay : otherMonth.days) {
+                DayNode& dayNode = monthNode.days[otherDay.day];
+                dayNode.day = otherDay.day;
+
+                if ((dayNode.minutes & otherDay.minutes).any()) {
+                    // Dzień z powtórzonymi minutami scalany jest rekord po rekordzie według polityki duplikatów
+                    float values[CHANNEL_COUNT];
+                    for (const QuarterNode& otherQuarter : otherDay.quarters) {
+                        for (size_t i = 0; i < otherQuarter.size(); ++i) {
+                            for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                                values[channel] = otherQuarter.channels[channel][i];
+                            }
+                            addRecord(otherQuarter.timestamps[i], values);
+                        }
+                    }
+                    continue;
+                }
 
-                    for (const auto& lineData : quarterNode.data) {
-                        lineData.printData();
+                dayNode.minutes |= otherDay.minutes;
+                dayNode.aggregate.merge(otherDay.aggregate);
+                monthNode.aggregate.merge(otherDay.aggregate);
+                yearNode.aggregate.merge(otherDay.aggregate);
+
+                for (const QuarterNode& otherQuarter : otherDay.quarters) {
+                    QuarterNode& quarterNode = quarterAt(dayNode, otherQuarter.quarter);
+
+                    if (quarterNode.size() == 0) {
+                        // Kolumny drugiego drzewa leżą w jego arenie, więc są kopiowane do bieżącej
+                        quarterNode.assign(otherQuarter);
+                    } else if (otherQuarter.size() > 0 && otherQuarter.timestamps.front() >= quarterNode.timestamps.back()) {
+                        quarterNode.timestamps.insert(quarterNode.timestamps.end(),
+                            otherQuarter.timestamps.begin(), otherQuarter.timestamps.end());
+                        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                            quarterNode.channels[channel].insert(quarterNode.channels[channel].end(),
+                                otherQuarter.channels[channel].begin(), otherQuarter.channels[channel].end());
+                        }
+                        quarterNode.aggregate.merge(otherQuarter.aggregate);
+                        for (size_t slot = 0; slot < quarterNode.hours.size(); ++slot) {
+                            quarterNode.hours[slot].merge(otherQuarter.hours[slot]);
+                        }
+                    } else {
+                        float values[CHANNEL_COUNT];
+                        for (size_t i = 0; i < otherQuarter.size(); ++i) {
+                            for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                                values[channel] = otherQuarter.channels[channel][i];
+                            }
+                            quarterNode.append(otherQuarter.timestamps[i], values);
+                        }
                     }
+                    quarterNode.indexed = false;
                 }
             }
         }
     }
+
+    other.clear();
 }
 
-std::vector<LineData> TreeData::getDataBetweenDates(const std::string& startDate, const std::string& endDate) const {
-    std::vector<LineData> result;
+void TreeData::addColumns(const int64_t* timestamps, const float* const channels[CHANNEL_COUNT], size_t count) {
+    size_t runBegin = 0;
+    while (runBegin < count) {
+        int64_t quarterKey = timestamps[runBegin] / 360 - (timestamps[runBegin] % 360 < 0 ? 1 : 0);
+        size_t runEnd = runBegin + 1;
+        while (runEnd < count) {
+            int64_t key = timestamps[runEnd] / 360 - (timestamps[runEnd] % 360 < 0 ? 1 : 0);
+            if (key != quarterKey) {
+                break;
+            }
+            ++runEnd;
+        }
 
-    std::tm tm = {};
-    std::istringstream ss(startDate);
-    ss >> std::get_time(&tm, "%d.%m.%Y %H:%M");
-    time_t start = mktime(&tm);
-
-    ss.clear();
-    ss.str(endDate);
-    ss >> std::get_time(&tm, "%d.%m.%Y %H:%M");
-    time_t end = mktime(&tm);
-
-    for (const auto& yearPair : years) {
-        const YearNode& yearNode = yearPair.second;
-        for (const auto& monthPair : yearNode.months) {
-            const MonthNode& monthNode = monthPair.second;
-            for (const auto& dayPair : monthNode.days) {
-                const DayNode& dayNode = dayPair.second;
-                for (const auto& quarterPair : dayNode.quarters) {
-                    const QuarterNode& quarterNode = quarterPair.second;
-                    for (const auto& lineData : quarterNode.data) {
-                        std::tm tm = {};
-                        std::istringstream ss(lineData.getDate());
-                        ss >> std::get_time(&tm, "%d.%m.%Y %H:%M");
-                        time_t dataTime = mktime(&tm);
-
-                        if (dataTime >= start && dataTime <= end) {
-                            result.push_back(lineData);
-                        }
+        int year, month, day, hour, minute;
+        splitTimestamp(timestamps[runEnd - 1], year, month, day, hour, minute);
+        int quarter = (hour * 60 + minute) / 360;
+
+        YearNode& yearNode = yearAt(year);
+        MonthNode& monthNode = monthAt(yearNode, month);
+        DayNode& dayNode = monthNode.days[day];
+        dayNode.day = day;
+        QuarterNode& quarterNode = quarterAt(dayNode, quarter);
+        quarterNode.quarter = quarter;
+        quarterNode.hour = hour;
+        quarterNode.minute = minute;
+
+        // Szybka ścieżka tylko dla serii rosnącej, bez minut już obecnych w dniu
+        Aggregate runAggregate;
+        float values[CHANNEL_COUNT];
+        int64_t dayStart = timestamps[runEnd - 1] - (hour * 60 + minute);
+        bool sortedRun = quarterNode.size() == 0 || quarterNode.timestamps.back() < timestamps[runBegin];
+        for (size_t i = runBegin; i < runEnd && sortedRun; ++i) {
+            sortedRun = (i == runBegin || timestamps[i - 1] < timestamps[i])
+                && !dayNode.minutes.test(static_cast<size_t>(timestamps[i] - dayStart));
+        }
+
+        if (sortedRun) {
+            quarterNode.timestamps.insert(quarterNode.timestamps.end(), timestamps + runBegin, timestamps + runEnd);
+            for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                quarterNode.channels[channel].insert(quarterNode.channels[channel].end(),
+                    channels[channel] + runBegin, channels[channel] + runEnd);
+            }
+            for (size_t i = runBegin; i < runEnd; ++i) {
+                dayNode.minutes.set(static_cast<size_t>(timestamps[i] - dayStart));
+            }
+            runAggregate = quarterNode.addHours(timestamps, channels, runBegin, runEnd);
+            quarterNode.aggregate.merge(runAggregate);
+            quarterNode.indexed = false;
+            dayNode.aggregate.merge(runAggregate);
+            monthNode.aggregate.merge(runAggregate);
+            yearNode.aggregate.merge(runAggregate);
+        } else {
+            for (size_t i = runBegin; i < runEnd; ++i) {
+                for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                    values[channel] = channels[channel][i];
+                }
+                addRecord(timestamps[i], values);
+            }
+        }
+
+        runBegin = runEnd;
+    }
+}
+
+void TreeData::exportColumns(std::vector<int64_t>& timestamps, std::vector<float> (&channels)[CHANNEL_COUNT]) const {
+    size_t total = timestamps.size() + size();
+    timestamps.reserve(total);
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        channels[channel].reserve(total);
+    }
+
+    for (const auto& yearNode : years) {
+        if (!yearNode) {
+            continue;
+        }
+        for (const auto& monthNode : yearNode->months) {
+            for (const DayNode& dayNode : monthNode->days) {
+                for (const QuarterNode& quarterNode : dayNode.quarters) {
+                    timestamps.insert(timestamps.end(), quarterNode.timestamps.begin(), quarterNode.timestamps.end());
+                    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                        channels[channel].insert(channels[channel].end(),
+                            quarterNode.channels[channel].begin(), quarterNode.channels[channel].end());
                     }
                 }
             }
         }
     }
+}
 
-    return result;
+/**
+ * @brief Sprawdza, czy w miesiącu jest kwartał z nieaktualnym indeksem wartości.
+ */
+static bool hasStaleIndex(const TreeData::MonthNode& monthNode) {
+    for (const TreeData::DayNode& dayNode : monthNode.days) {
+        for (const TreeData::QuarterNode& quarterNode : dayNode.quarters) {
+            if (!quarterNode.indexed) {
+                return true;
+            }
+        }
+    }
+    return false;
 }
 
-void TreeData::calculateSumsBetweenDates(const std::string& startDate, const std::string& endDate, float& autokonsumpcjaSum, float& eksportSum, float& importSum, float& poborSum, float& produkcjaSum) const {
-    autokonsumpcjaSum = 0.0f;
-    eksportSum = 0.0f;
-    importSum = 0.0f;
-    poborSum = 0.0f;
-    produkcjaSum = 0.0f;
+void TreeData::buildIndexes() {
+    for (size_t index = 0; index < years.size(); ++index) {
+        if (!years[index]) {
+            continue;
+        }
+        int year = years[index]->year;
+        for (int month = 1; month <= 12; ++month) {
+            // Do zapisu pobierane są tylko miesiące wymagające przebudowy, aby nie kopiować współdzielonych
+            const std::shared_ptr<MonthNode>* monthSlot = years[index]->months.find(month);
+            if (monthSlot == nullptr || !hasStaleIndex(**monthSlot)) {
+                continue;
+            }
+            for (DayNode& dayNode : monthAt(yearAt(year), month).days) {
+                for (QuarterNode& quarterNode : dayNode.quarters) {
+                    if (!quarterNode.indexed) {
+                        quarterNode.buildIndex();
+                    }
+                }
+            }
+        }
+    }
+}
 
-    std::vector<LineData> data = getDataBetweenDates(startDate, endDate);
-    for (const auto& lineData : data) {
-        autokonsumpcjaSum += lineData.getAutokonsumpcja();
-        eksportSum += lineData.getEksport();
-        importSum += lineData.getImport();
-        poborSum += lineData.getPobor();
-        produkcjaSum += lineData.getProdukcja();
+size_t TreeData::size() const {
+    size_t count = 0;
+    for (const auto& yearNode : years) {
+        if (yearNode) {
+            count += yearNode->aggregate.count;
+        }
     }
+    return count;
 }
 
-void TreeData::calculateAveragesBetweenDates(const std::string& startDate, const std::string& endDate, float& autokonsumpcjaAvg, float& eksportAvg, float& importAvg, float& poborAvg, float& produkcjaAvg) const {
-    float autokonsumpcjaSum = 0.0f, eksportSum = 0.0f, importSum = 0.0f, poborSum = 0.0f, produkcjaSum = 0.0f;
-    int count = 0;
-
-    std::vector<LineData> data = getDataBetweenDates(startDate, endDate);
-    for (const auto& lineData : data) {
-        autokonsumpcjaSum += lineData.getAutokonsumpcja();
-        eksportSum += lineData.getEksport();
-        importSum += lineData.getImport();
-        poborSum += lineData.getPobor();
-        produkcjaSum += lineData.getProdukcja();
-        count++;
-    }
-
-    if (count > 0) {
-        autokonsumpcjaAvg = autokonsumpcjaSum / count;
-        eksportAvg = eksportSum / count;
-        importAvg = importSum / count;
-        poborAvg = poborSum / count;
-        produkcjaAvg = produkcjaSum / count;
-    } else {
-        autokonsumpcjaAvg = eksportAvg = importAvg = poborAvg = produkcjaAvg = 0.0f;
+void TreeData::clear() {
+    years.clear();
+    if (arena && !isExclusive(arena)) {
+        arena = std::make_shared<Arena>();
+    } else if (arena) {
+        arena->pool.release();
+        arena->buffer.release();
     }
+    firstYear = 0;
+    duplicateCount = 0;
 }
 
-void TreeData::serialize(std::ofstream& out) const {
-    for (const auto& yearPair : years) {
-        const YearNode& yearNode = yearPair.second;
-        for (const auto& monthPair : yearNode.months) {
-            const MonthNode& monthNode = monthPair.second;
-            for (const auto& dayPair : monthNode.days) {
-                const DayNode& dayNode = dayPair.second;
-                for (const auto& quarterPair : dayNode.quarters) {
-                    const QuarterNode& quarterNode = quarterPair.second;
-                    for (const auto& lineData : quarterNode.data) {
-                        lineData.serialize(out);
+void TreeData::print() const {
+    for (const auto& yearSlot : years) {
+        if (!yearSlot) {
+            continue;
+        }
+        const YearNode& yearNode = *yearSlot;
+        cout << "Year: " << yearNode.year << endl;
+
+        for (const auto& monthNode : yearNode.months) {
+            cout << "\tMonth: " << monthNode->month << endl;
+
+            for (const DayNode& dayNode : monthNode->days) {
+                cout << "\t\tDay: " << dayNode.day << endl;
+
+                for (const QuarterNode& quarterNode : dayNode.quarters) {
+                    cout << "\t\t\tQuarter: " << quarterNode.quarter
+                        << " (Hour: " << quarterNode.hour << ", Minute: " << quarterNode.minute << ")" << endl;
+
+                    for (size_t i = 0; i < quarterNode.size(); ++i) {
+                        quarterNode.getRecord(i).printData();
                     }
                 }
             }
@@ -158,57 +603,174 @@ void TreeData::serialize(std::ofstream& out) const {
     }
 }
 
-void TreeData::compareDataBetweenDates(const std::string& startDate1, const std::string& endDate1, const std::string& startDate2, const std::string& endDate2, float& autokonsumpcjaDiff, float& eksportDiff, float& importDiff, float& poborDiff, float& produkcjaDiff) const {
-    std::vector<LineData> data1 = getDataBetweenDates(startDate1, endDate1);
-    std::vector<LineData> data2 = getDataBetweenDates(startDate2, endDate2);
+template <typename Collect>
+std::vector<LineData> TreeData::collectByMonths(int64_t start, int64_t end, Collect&& collect) const {
+    int startYear, startMonth, endYear, endMonth, day, hour, minute;
+    splitTimestamp(start, startYear, startMonth, day, hour, minute);
+    splitTimestamp(end, endYear, endMonth, day, hour, minute);
+
+    // Części przedziału przypadające na kolejne miesiące z rekordami
+    std::vector<std::pair<int64_t, int64_t>> parts;
+    size_t records = 0;
+    int lastYear = std::min(endYear, firstYear + static_cast<int>(years.size()) - 1);
+    for (int year = std::max(startYear, firstYear); start <= end && year <= lastYear; ++year) {
+        const YearNode* yearNode = findYear(year);
+        if (yearNode == nullptr) {
+            continue;
+        }
+        for (const auto& monthNode : yearNode->months.range(year == startYear ? startMonth : 1, year == endYear ? endMonth : 12)) {
+            int month = monthNode->month;
+            int64_t monthStart = makeTimestamp(year, month, 1, 0, 0);
+            int64_t monthEnd = (month == 12 ? makeTimestamp(year + 1, 1, 1, 0, 0) : makeTimestamp(year, month + 1, 1, 0, 0)) - 1;
+            parts.emplace_back(std::max(start, monthStart), std::min(end, monthEnd));
+            records += monthNode->aggregate.count;
+        }
+    }
 
-    float autokonsumpcjaSum1 = 0.0f, eksportSum1 = 0.0f, importSum1 = 0.0f, poborSum1 = 0.0f, produkcjaSum1 = 0.0f;
-    for (const auto& lineData : data1) {
-        autokonsumpcjaSum1 += lineData.getAutokonsumpcja();
-        eksportSum1 += lineData.getEksport();
-        importSum1 += lineData.getImport();
-        poborSum1 += lineData.getPobor();
-        produkcjaSum1 += lineData.getProdukcja();
+    std::vector<LineData> result;
+    if (parts.size() < 2 || records < PARALLEL_MIN_RECORDS) {
+        collect(start, end, result);
+        return result;
     }
 
-    float autokonsumpcjaSum2 = 0.0f, eksportSum2 = 0.0f, importSum2 = 0.0f, poborSum2 = 0.0f, produkcjaSum2 = 0.0f;
-    for (const auto& lineData : data2) {
-        autokonsumpcjaSum2 += lineData.getAutokonsumpcja();
-        eksportSum2 += lineData.getEksport();
-        importSum2 += lineData.getImport();
-        poborSum2 += lineData.getPobor();
-        produkcjaSum2 += lineData.getProdukcja();
+    std::vector<std::vector<LineData>> partResults(parts.size());
+    ThreadPool::shared().forEachIndex(parts.size(), [&](size_t index) {
+        collect(parts[index].first, parts[index].second, partResults[index]);
+    });
+
+    size_t total = 0;
+    for (const std::vector<LineData>& part : partResults) {
+        total += part.size();
     }
+    result.reserve(total);
+    for (std::vector<LineData>& part : partResults) {
+        std::move(part.begin(), part.end(), std::back_inserter(result));
+    }
+    return result;
+}
 
-    autokonsumpcjaDiff = autokonsumpcjaSum2 - autokonsumpcjaSum1;
-    eksportDiff = eksportSum2 - eksportSum1;
-    importDiff = importSum2 - importSum1;
-    poborDiff = poborSum2 - poborSum1;
-    produkcjaDiff = produkcjaSum2 - produkcjaSum1;
+std::vector<LineData> TreeData::getDataBetweenDates(const std::string& startDate, const std::string& endDate) const {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return std::vector<LineData>();
+    }
+    return collectByMonths(start, end, [this](int64_t from, int64_t to, std::vector<LineData>& records) {
+        visitBetween(from, to, [&records](const RecordView& record) {
+            records.push_back(record.toLineData());
+        });
+    });
 }
 
-std::vector<LineData> TreeData::searchRecordsWithTolerance(const std::string& startDate, const std::string& endDate, float value, float tolerance) const {
-    std::vector<LineData> result;
+std::vector<LineData> TreeData::getDataBetweenDates(const std::string& startDate, const std::string& endDate, const Predicate& predicate) const {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return std::vector<LineData>();
+    }
+    return collectByMonths(start, end, [this, &predicate](int64_t from, int64_t to, std::vector<LineData>& records) {
+        visitBetween(from, to, predicate, [&records](const RecordView& record) {
+            records.push_back(record.toLineData());
+        });
+    });
+}
+
+Aggregate TreeData::aggregateBetween(int64_t start, int64_t end) const {
+    Aggregate result;
+
+    descendBetween(start, end,
+        [&result](const Aggregate& aggregate) {
+            result.merge(aggregate);
+            return true;
+        },
+        [&result](const QuarterNode& quarterNode, size_t begin, size_t finish) {
+            const float* columns[CHANNEL_COUNT];
+            quarterNode.getColumns(columns);
+            result.addColumns(columns, begin, finish);
+        });
+
+    return result;
+}
+
+Aggregate TreeData::aggregateBetweenDates(const std::string& startDate, const std::string& endDate) const {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return Aggregate();
+    }
+
+    return aggregateBetween(start, end);
+}
+
+std::vector<RollupPoint> TreeData::groupBetween(int64_t start, int64_t end, BucketSize bucket) const {
+    std::vector<RollupPoint> points;
+    if (start > end) {
+        return points;
+    }
+
+    if (bucket == BUCKET_15_MIN) {
+        // Kwadranse są krótsze niż agregaty godzinowe, więc liczone są z kolejnych serii rekordów
+        descendBetween(start, end,
+            [](const Aggregate&) { return false; },
+            [&points](const QuarterNode& quarterNode, size_t begin, size_t finish) {
+                const float* columns[CHANNEL_COUNT];
+                quarterNode.getColumns(columns);
+                addColumnsToSeries(points, BUCKET_15_MIN, quarterNode.timestamps.data(), columns, begin, finish);
+            });
+        return points;
+    }
+
+    int startYear, startMonth, startDay, startHour, startMinute;
+    int endYear, endMonth, endDay, endHour, endMinute;
+    splitTimestamp(start, startYear, startMonth, startDay, startHour, startMinute);
+    splitTimestamp(end, endYear, endMonth, endDay, endHour, endMinute);
+    int startQuarter = (startHour * 60 + startMinute) / 360;
+    int endQuarter = (endHour * 60 + endMinute) / 360;
+
+    // Węzeł w całości w zakresie dołączany jest z agregatu, przycięty - liczony przez aggregateBetween
+    auto addNode = [&](int64_t nodeStart, int64_t nodeEnd, const Aggregate& aggregate) {
+        if (nodeStart >= start && nodeEnd <= end) {
+            mergeIntoSeries(points, bucketStart(nodeStart, bucket), aggregate);
+        } else if (nodeStart <= end && nodeEnd >= start) {
+            int64_t first = std::max(start, nodeStart);
+            mergeIntoSeries(points, bucketStart(first, bucket), aggregateBetween(first, std::min(end, nodeEnd)));
+        }
+    };
 
-    std::tm tm = {};
-    std::istringstream ss(startDate);
-    ss >> std::get_time(&tm, "%d.%m.%Y %H:%M");
-
-    ss.clear();
-    ss.str(endDate);
-    ss >> std::get_time(&tm, "%d.%m.%Y %H:%M");
-
-    for (const auto& yearPair : years) {
-        const YearNode& yearNode = yearPair.second;
-        for (const auto& monthPair : yearNode.months) {
-            const MonthNode& monthNode = monthPair.second;
-            for (const auto& dayPair : monthNode.days) {
-                const DayNode& dayNode = dayPair.second;
-                for (const auto& quarterPair : dayNode.quarters) {
-                    const QuarterNode& quarterNode = quarterPair.second;
-                    for (const auto& lineData : quarterNode.data) {
-                        if (lineData.getAutokonsumpcja() >= value - tolerance && lineData.getAutokonsumpcja() <= value + tolerance) {
-                            result.push_back(lineData);
+    int lastYear = std::min(endYear, firstYear + static_cast<int>(years.size()) - 1);
+    for (int year = std::max(startYear, firstYear); year <= lastYear; ++year) {
+        const YearNode* yearNode = findYear(year);
+        if (yearNode == nullptr) {
+            continue;
+        }
+        if (bucket == BUCKET_YEAR) {
+            addNode(makeTimestamp(year, 1, 1, 0, 0), makeTimestamp(year + 1, 1, 1, 0, 0) - 1, yearNode->aggregate);
+            continue;
+        }
+        bool yearLow = year == startYear;
+        bool yearHigh = year == endYear;
+
+        for (const auto& monthSlot : yearNode->months.range(yearLow ? startMonth : 1, yearHigh ? endMonth : 12)) {
+            const MonthNode& monthNode = *monthSlot;
+            int64_t monthStart = makeTimestamp(year, monthNode.month, 1, 0, 0);
+            if (bucket == BUCKET_MONTH) {
+                addNode(monthStart, bucketEnd(monthStart, BUCKET_MONTH), monthNode.aggregate);
+                continue;
+            }
+            bool monthLow = yearLow && monthNode.month == startMonth;
+            bool monthHigh = yearHigh && monthNode.month == endMonth;
+
+            for (const DayNode& dayNode : monthNode.days.range(monthLow ? startDay : 1, monthHigh ? endDay : 31)) {
+                int64_t dayStart = monthStart + (dayNode.day - 1) * 24 * 60;
+                if (bucket == BUCKET_DAY || bucket == BUCKET_WEEK) {
+                    addNode(dayStart, dayStart + 24 * 60 - 1, dayNode.aggregate);
+                    continue;
+                }
+                bool dayLow = monthLow && dayNode.day == startDay;
+                bool dayHigh = monthHigh && dayNode.day == endDay;
+
+                for (const QuarterNode& quarterNode : dayNode.quarters.range(dayLow ? startQuarter : 0, dayHigh ? endQuarter : 3)) {
+                    for (size_t slot = 0; slot < quarterNode.hours.size(); ++slot) {
+                        int64_t hourStart = dayStart + quarterNode.quarter * 360 + static_cast<int64_t>(slot) * 60;
+                        if (!quarterNode.hours[slot].empty()) {
+                            addNode(hourStart, hourStart + 59, quarterNode.hours[slot]);
                         }
                     }
                 }
@@ -216,5 +778,139 @@ std::vector<LineData> TreeData::searchRecordsWithTolerance(const std::string& st
         }
     }
 
+    return points;
+}
+
+std::vector<RollupPoint> TreeData::rollupBetweenDates(const std::string& startDate, const std::string& endDate,
+    Resolution resolution) const {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return std::vector<RollupPoint>();
+    }
+
+    BucketSize bucket = resolution == RESOLUTION_HOUR ? BUCKET_HOUR
+        : resolution == RESOLUTION_DAY ? BUCKET_DAY : BUCKET_MONTH;
+    return groupBetween(start, end, bucket);
+}
+
+std::vector<GroupRow> TreeData::groupBetweenDates(const std::string& startDate, const std::string& endDate,
+    const GroupBy& groupBy) const {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return std::vector<GroupRow>();
+    }
+
+    return selectGroups(groupBetween(start, end, groupBy.bucket), groupBy);
+}
+
+Resolution TreeData::selectResolution(const std::string& startDate, const std::string& endDate, size_t maxPoints) {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end) || start > end) {
+        return RESOLUTION_MONTH;
+    }
+
+    // Liczba rozpoczętych godzin i dób w przedziale (dzielenie z zaokrągleniem w dół także przed 1970)
+    auto bucketCount = [start, end](int64_t length) {
+        int64_t first = start / length - (start % length < 0 ? 1 : 0);
+        int64_t last = end / length - (end % length < 0 ? 1 : 0);
+        return static_cast<uint64_t>(last - first + 1);
+    };
+    if (bucketCount(60) <= maxPoints) {
+        return RESOLUTION_HOUR;
+    }
+    if (bucketCount(24 * 60) <= maxPoints) {
+        return RESOLUTION_DAY;
+    }
+    return RESOLUTION_MONTH;
+}
+
+Aggregate TreeData::aggregateBetweenDates(const std::string& startDate, const std::string& endDate, const Predicate& predicate) const {
+    Aggregate result;
+
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return result;
+    }
+
+    std::vector<uint8_t> mask, scratch;
+    descendBetween(start, end,
+        [&](const Aggregate& aggregate) {
+            if (!predicate.mayMatch(aggregate)) {
+                return true;
+            }
+            if (predicate.matchesAll(aggregate)) {
+                result.merge(aggregate);
+                return true;
+            }
+            return false;
+        },
+        [&](const QuarterNode& quarterNode, size_t begin, size_t finish) {
+            const float* columns[CHANNEL_COUNT];
+            quarterNode.getColumns(columns);
+            predicate.evaluate(columns, begin, finish, mask, scratch);
+
+            float values[CHANNEL_COUNT];
+            for (size_t i = begin; i < finish; ++i) {
+                if (mask[i - begin]) {
+                    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                        values[channel] = columns[channel][i];
+                    }
+                    result.add(values);
+                }
+            }
+        });
+
     return result;
 }
+
+void TreeData::calculateSumsBetweenDates(const std::string& startDate, const std::string& endDate, float& autokonsumpcjaSum, float& eksportSum, float& importSum, float& poborSum, float& produkcjaSum) const {
+    Aggregate aggregate = aggregateBetweenDates(startDate, endDate);
+
+    autokonsumpcjaSum = static_cast<float>(aggregate.sum[AUTOKONSUMPCJA]);
+    eksportSum = static_cast<float>(aggregate.sum[EKSPORT]);
+    importSum = static_cast<float>(aggregate.sum[IMPORT]);
+    poborSum = static_cast<float>(aggregate.sum[POBOR]);
+    produkcjaSum = static_cast<float>(aggregate.sum[PRODUKCJA]);
+}
+
+void TreeData::calculateAveragesBetweenDates(const std::string& startDate, const std::string& endDate, float& autokonsumpcjaAvg, float& eksportAvg, float& importAvg, float& poborAvg, float& produkcjaAvg) const {
+    Aggregate aggregate = aggregateBetweenDates(startDate, endDate);
+
+    autokonsumpcjaAvg = static_cast<float>(aggregate.average(AUTOKONSUMPCJA));
+    eksportAvg = static_cast<float>(aggregate.average(EKSPORT));
+    importAvg = static_cast<float>(aggregate.average(IMPORT));
+    poborAvg = static_cast<float>(aggregate.average(POBOR));
+    produkcjaAvg = static_cast<float>(aggregate.average(PRODUKCJA));
+}
+
+void TreeData::serialize(std::ofstream& out, bool compressed) const {
+    Snapshot::write(*this, out, compressed);
+}
+
+void TreeData::deserialize(std::ifstream& in) {
+    Snapshot::read(in, *this);
+}
+
+void TreeData::compareDataBetweenDates(const std::string& startDate1, const std::string& endDate1, const std::string& startDate2, const std::string& endDate2, float& autokonsumpcjaDiff, float& eksportDiff, float& importDiff, float& poborDiff, float& produkcjaDiff) const {
+    float sums1[CHANNEL_COUNT], sums2[CHANNEL_COUNT];
+    calculateSumsBetweenDates(startDate1, endDate1, sums1[AUTOKONSUMPCJA], sums1[EKSPORT], sums1[IMPORT], sums1[POBOR], sums1[PRODUKCJA]);
+    calculateSumsBetweenDates(startDate2, endDate2, sums2[AUTOKONSUMPCJA], sums2[EKSPORT], sums2[IMPORT], sums2[POBOR], sums2[PRODUKCJA]);
+
+    autokonsumpcjaDiff = sums2[AUTOKONSUMPCJA] - sums1[AUTOKONSUMPCJA];
+    eksportDiff = sums2[EKSPORT] - sums1[EKSPORT];
+    importDiff = sums2[IMPORT] - sums1[IMPORT];
+    poborDiff = sums2[POBOR] - sums1[POBOR];
+    produkcjaDiff = sums2[PRODUKCJA] - sums1[PRODUKCJA];
+}
+
+std::vector<LineData> TreeData::searchRecordsWithTolerance(const std::string& startDate, const std::string& endDate, float value, float tolerance, Channel channel) const {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return std::vector<LineData>();
+    }
+    return collectByMonths(start, end, [&](int64_t from, int64_t to, std::vector<LineData>& records) {
+        visitWithTolerance(from, to, value, tolerance, channel, [&records](const RecordView& record) {
+            records.push_back(record.toLineData());
+        });
+    });
+}
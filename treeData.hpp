@@ -6,10 +6,41 @@
 #ifndef TREEDATA_H
 #define TREEDATA_H
 
-#include <map>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <algorithm>
 #include <vector>
+#include "aggregate.hpp"
+#include "calendarSlots.hpp"
+#include "dateTime.hpp"
+#include "groupBy.hpp"
 #include "lineData.hpp"
+#include "predicate.hpp"
+#include "recordView.hpp"
+
+/**
+ * @enum DuplicatePolicy
+ * @brief Sposób obsługi rekordu o znaczniku czasu, który już istnieje w drzewie.
+ */
+enum DuplicatePolicy {
+    DUPLICATE_SKIP,     ///< Pozostaw istniejący rekord, pomiń nowy
+    DUPLICATE_REPLACE,  ///< Zastąp wartości istniejącego rekordu wartościami nowego
+    DUPLICATE_FLAG,     ///< Pozostaw istniejący rekord, a nowy zapisz do `loggerError`
+    DUPLICATE_KEEP      ///< Dodaj nowy rekord obok istniejącego (np. powtórzona godzina przy zmianie czasu)
+};
+
+/**
+ * @enum Resolution
+ * @brief Rozdzielczość serii zagregowanej (`TreeData::rollupBetweenDates`).
+ */
+enum Resolution {
+    RESOLUTION_HOUR,   ///< Agregaty godzinowe
+    RESOLUTION_DAY,    ///< Agregaty dobowe
+    RESOLUTION_MONTH   ///< Agregaty miesięczne
+};
 
 /**
  * @class TreeData
@@ -17,6 +48,21 @@
  * 
  * Klasa ta przechowuje dane w strukturze hierarchicznej (Rok -> Miesiąc -> Dzień -> Kwartał), 
  * umożliwiając dodawanie, przetwarzanie i analizowanie danych dotyczących energii w różnych okresach.
+ *
+ * Lata leżą w katalogu indeksowanym numerem roku, a miesiące, dni i kwartały w tablicach
+ * `CalendarSlots` o stałym rozmiarze, więc odnalezienie węzła rekordu to wyłącznie arytmetyka.
+ *
+ * Oprócz agregatów lat, miesięcy, dni i kwartałów każdy kwartał utrzymuje agregaty swoich godzin,
+ * więc zapytania zakresowe i serie zagregowane korzystają z najgrubszej rozdzielczości, która daje
+ * dokładny wynik, a pojedyncze rekordy przeglądane są tylko w niepełnych godzinach na krańcach przedziału.
+ *
+ * Kolumny kwartałów alokowane są z areny należącej do drzewa (pula bloków nad buforem monotonicznym),
+ * więc wczytywanie dużych zbiorów to głównie przesuwanie wskaźnika, a `clear` zwalnia całą pamięć naraz.
+ *
+ * Lata i miesiące są współdzielone przez kopie drzewa (kopiowanie przy zapisie): kopia drzewa kopiuje
+ * tylko katalog lat, a pierwsza zmiana w roku lub miesiącu współdzielonym z inną kopią kopiuje wyłącznie
+ * ten węzeł. Dzięki temu kolejne wersje drzewa (zob. `TreeStore`) kosztują tyle, ile zmienione miesiące,
+ * a wersja czytana w innym wątku nigdy nie jest modyfikowana.
  */
 class TreeData {
 public:
@@ -26,56 +72,260 @@ public:
      * @brief Struktura przechowująca dane o kwartale w ciągu godziny.
      * 
      * Zawiera informacje o kwartale, godzinie, minucie oraz dane związane z energią w tym czasie.
+     * Rekordy są przechowywane kolumnowo: osobna kolumna znaczników czasu oraz po jednej
+     * ciągłej kolumnie wartości dla każdego kanału, indeksowanej wartością `Channel`.
      */
     struct QuarterNode {
         int quarter; /**< Numer kwartału (1-4). */
         int hour; /**< Godzina. */
         int minute; /**< Minuta. */
-        std::vector<LineData> data; /**< Dane dotyczące energii w tym kwartale. */
+        std::pmr::vector<int64_t> timestamps; /**< Znaczniki czasu rekordów (minuty od 01.01.1970). */
+        std::pmr::vector<float> channels[CHANNEL_COUNT]; /**< Kolumny wartości, po jednej na kanał. */
+        Aggregate aggregate; /**< Agregaty wszystkich rekordów w kwartale. */
+        std::pmr::vector<Aggregate> hours; /**< Agregaty sześciu godzin kwartału (indeks z `hourSlot`). */
+        std::pmr::vector<uint32_t> valueIndex[CHANNEL_COUNT]; /**< Pozycje rekordów posortowane według wartości kanału. */
+        bool indexed = false; /**< Czy `valueIndex` odpowiada bieżącej zawartości kolumn. */
+
+        /**
+         * @brief Zwraca liczbę rekordów w kwartale.
+         */
+        size_t size() const { return timestamps.size(); }
+
+        /**
+         * @brief Przełącza puste kolumny i indeksy kwartału na alokację z podanego zasobu pamięci.
+         * @param resource Zasób pamięci drzewa.
+         */
+        void bind(std::pmr::memory_resource* resource);
+
+        /**
+         * @brief Kopiuje zawartość innego kwartału (kolumny, agregaty i indeksy) do zasobu pamięci tego kwartału.
+         * @param other Kwartał źródłowy, np. z innej areny.
+         */
+        void assign(const QuarterNode& other);
+
+        /**
+         * @brief Zwraca pozycję godziny znacznika czasu w kwartale (0-5).
+         */
+        static size_t hourSlot(int64_t timestamp) { return static_cast<size_t>((timestamp % 360 + 360) % 360 / 60); }
+
+        /**
+         * @brief Dodaje serię rekordów do agregatów godzin kwartału.
+         *
+         * Seria dzielona jest na godziny, a agregat każdej części liczony jest jednym przebiegiem po kolumnach.
+         *
+         * @param timestamps Kolumna znaczników czasu (rosnąca w zakresie [begin, end)).
+         * @param channels Kolumny wartości kanałów (indeksowane `Channel`).
+         * @param begin Indeks pierwszego rekordu.
+         * @param end Indeks za ostatnim rekordem.
+         * @return Agregat całej serii.
+         */
+        Aggregate addHours(const int64_t* timestamps, const float* const channels[CHANNEL_COUNT], size_t begin, size_t end);
+
+        /**
+         * @brief Liczy od nowa agregat kwartału i agregaty godzin z zawartości kolumn.
+         */
+        void rebuildAggregates();
+
+        /**
+         * @brief Wstawia rekord do kolumn, zachowując rosnącą kolejność znaczników czasu.
+         *
+         * Rekordy dopisywane chronologicznie trafiają na koniec kolumn bez przesuwania danych.
+         *
+         * @param timestamp Znacznik czasu rekordu.
+         * @param values Wartości kanałów rekordu (indeksowane `Channel`).
+         */
+        void append(int64_t timestamp, const float values[CHANNEL_COUNT]);
+
+        /**
+         * @brief Odtwarza rekord `LineData` z kolumn.
+         * @param index Pozycja rekordu w kwartale.
+         * @return Rekord z datą w formacie tekstowym.
+         */
+        LineData getRecord(size_t index) const;
+
+        /**
+         * @brief Wypełnia tablicę wskaźników na kolumny kanałów kwartału.
+         * @param columns Tablica wynikowa (indeksowana `Channel`).
+         */
+        void getColumns(const float* columns[CHANNEL_COUNT]) const;
+
+        /**
+         * @brief Buduje indeks wartości dla wszystkich kanałów.
+         */
+        void buildIndex();
+
+        /**
+         * @brief Wyszukuje rekordy, których wartość kanału mieści się w przedziale [low, high].
+         *
+         * Korzysta z indeksu wartości, jeśli jest aktualny; w przeciwnym razie przegląda kolumnę.
+         *
+         * @param channel Kanał pomiarowy.
+         * @param low Dolna granica wartości.
+         * @param high Górna granica wartości.
+         * @param begin Indeks pierwszego rozpatrywanego rekordu.
+         * @param end Indeks za ostatnim rozpatrywanym rekordem.
+         * @param positions Pozycje pasujących rekordów w rosnącej kolejności (wyjście, dopisywane).
+         */
+        void findValues(Channel channel, float low, float high, size_t begin, size_t end,
+            std::vector<uint32_t>& positions) const;
     };
 
     /**
      * @struct DayNode
      * @brief Struktura przechowująca dane o dniu.
      * 
-     * Zawiera mapę, która odwzorowuje kwartalną strukturę danych.
+     * Zawiera tablicę kwartałów (sześciogodzinnych części doby) indeksowaną numerem kwartału 0-3.
      */
     struct DayNode {
         int day; /**< Numer dnia. */
-        std::map<int, QuarterNode> quarters; /**< Mapa kwartali w danym dniu. */
+        CalendarSlots<QuarterNode, 4, 0> quarters; /**< Kwartały w danym dniu. */
+        Aggregate aggregate; /**< Agregaty wszystkich rekordów w dniu. */
+        std::bitset<24 * 60> minutes; /**< Minuty doby, dla których istnieje rekord (wykrywanie duplikatów w O(1)). */
     };
 
     /**
      * @struct MonthNode
      * @brief Struktura przechowująca dane o miesiącu.
      * 
-     * Zawiera mapę dni w danym miesiącu.
+     * Zawiera tablicę dni w danym miesiącu indeksowaną numerem dnia 1-31.
      */
     struct MonthNode {
         int month; /**< Numer miesiąca. */
-        std::map<int, DayNode> days; /**< Mapa dni w danym miesiącu. */
+        CalendarSlots<DayNode, 31, 1> days; /**< Dni w danym miesiącu. */
+        Aggregate aggregate; /**< Agregaty wszystkich rekordów w miesiącu. */
     };
 
     /**
      * @struct YearNode
      * @brief Struktura przechowująca dane o roku.
      * 
-     * Zawiera mapę miesięcy w danym roku.
+     * Zawiera tablicę miesięcy w danym roku indeksowaną numerem miesiąca 1-12.
+     * Miesiące mogą być współdzielone z innymi kopiami drzewa.
      */
     struct YearNode {
         int year; /**< Numer roku. */
-        std::map<int, MonthNode> months; /**< Mapa miesięcy w danym roku. */
+        CalendarSlots<std::shared_ptr<MonthNode>, 12, 1> months; /**< Miesiące w danym roku. */
+        Aggregate aggregate; /**< Agregaty wszystkich rekordów w roku. */
     };
 
+    /**
+     * @brief Tworzy puste drzewo z własną areną pamięci.
+     */
+    TreeData();
+
+    /**
+     * @brief Tworzy kopię drzewa współdzielącą z nim lata, miesiące i arenę.
+     *
+     * Kopiowany jest tylko katalog lat; węzły kopiowane są dopiero przy pierwszej zmianie w jednej z kopii.
+     */
+    TreeData(const TreeData& other) = default;
+
+    /**
+     * @brief Przejmuje rekordy i arenę innego drzewa bez kopiowania.
+     */
+    TreeData(TreeData&& other) noexcept = default;
+
+    /**
+     * @brief Zwalnia bieżące rekordy i współdzieli rekordy oraz arenę innego drzewa.
+     */
+    TreeData& operator=(const TreeData& other);
+
+    /**
+     * @brief Zwalnia bieżące rekordy i przejmuje rekordy oraz arenę innego drzewa.
+     */
+    TreeData& operator=(TreeData&& other) noexcept;
+
     /**
      * @brief Dodaje dane do struktury TreeData.
      * 
      * Przetwarza dane i przypisuje je do odpowiednich kwartali, dni, miesięcy oraz lat.
+     * Rekord o istniejącym już znaczniku czasu obsługiwany jest zgodnie z `getDuplicatePolicy`.
      * 
      * @param lineData Dane do dodania.
      */
     void addData(const LineData& lineData);
 
+    /**
+     * @brief Dodaje rekord podany jako znacznik czasu i wartości kanałów.
+     * 
+     * Wariant `addData` nie wymagający budowania obiektu `LineData`, używany przy szybkim wczytywaniu danych.
+     * 
+     * @param timestamp Znacznik czasu rekordu (minuty od 01.01.1970 00:00).
+     * @param values Wartości kanałów rekordu (indeksowane `Channel`).
+     */
+    void addRecord(int64_t timestamp, const float values[CHANNEL_COUNT]);
+
+    /**
+     * @brief Dołącza do drzewa wszystkie rekordy innego drzewa.
+     * 
+     * Rekordy drugiego drzewa traktowane są tak, jakby zostały dodane po rekordach bieżącego drzewa,
+     * więc scalenie częściowych drzew w kolejności fragmentów pliku daje te same kolumny,
+     * co wczytanie sekwencyjne. Kwartały nieobecne w bieżącym drzewie są kopiowane do areny
+     * bieżącego drzewa jednym wstawieniem na kolumnę.
+     * Dni, w których oba drzewa mają rekordy z tej samej minuty, scalane są rekord po rekordzie
+     * zgodnie z polityką duplikatów bieżącego drzewa.
+     * 
+     * @param other Drzewo do dołączenia (po wywołaniu pozostaje w nieokreślonym stanie).
+     */
+    void merge(TreeData&& other);
+
+    /**
+     * @brief Dodaje wiele rekordów podanych jako kolumny.
+     * 
+     * Kolejne rekordy należące do tego samego kwartału są dopisywane do kolumn jednym wstawieniem,
+     * a ich agregaty są łączone z węzłami raz na serię. Najszybciej działa dla danych
+     * uporządkowanych chronologicznie, np. wczytywanych z migawki.
+     * 
+     * @param timestamps Kolumna znaczników czasu.
+     * @param channels Kolumny wartości kanałów (indeksowane `Channel`).
+     * @param count Liczba rekordów.
+     */
+    void addColumns(const int64_t* timestamps, const float* const channels[CHANNEL_COUNT], size_t count);
+
+    /**
+     * @brief Kopiuje wszystkie rekordy do kolumn w kolejności chronologicznej.
+     * @param timestamps Kolumna znaczników czasu (wyjście, dopisywana).
+     * @param channels Kolumny wartości kanałów (wyjście, dopisywane).
+     */
+    void exportColumns(std::vector<int64_t>& timestamps, std::vector<float> (&channels)[CHANNEL_COUNT]) const;
+
+    /**
+     * @brief Buduje indeksy wartości we wszystkich kwartałach zmienionych od poprzedniego wywołania.
+     *
+     * Dodanie rekordu unieważnia indeks jego kwartału; do czasu przebudowy wyszukiwanie
+     * w tym kwartale przegląda kolumnę. Należy wywołać po wczytaniu danych.
+     */
+    void buildIndexes();
+
+    /**
+     * @brief Ustawia sposób obsługi rekordów o istniejącym już znaczniku czasu.
+     * @param policy Polityka duplikatów (domyślnie `DUPLICATE_SKIP`).
+     */
+    void setDuplicatePolicy(DuplicatePolicy policy) { duplicatePolicy = policy; }
+
+    /**
+     * @brief Zwraca sposób obsługi rekordów o istniejącym już znaczniku czasu.
+     */
+    DuplicatePolicy getDuplicatePolicy() const { return duplicatePolicy; }
+
+    /**
+     * @brief Zwraca liczbę wykrytych dotąd duplikatów (niezależnie od polityki).
+     */
+    size_t getDuplicateCount() const { return duplicateCount; }
+
+    /**
+     * @brief Zwraca liczbę rekordów w drzewie.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Usuwa wszystkie rekordy z drzewa i zwalnia naraz całą pamięć areny.
+     *
+     * Jeśli arena jest współdzielona z kopią drzewa, drzewo przechodzi na nową arenę,
+     * a pamięć starej zwalniana jest razem z ostatnią kopią.
+     */
+    void clear();
+
     /**
      * @brief Drukuje dane w strukturze TreeData.
      * 
@@ -83,10 +333,54 @@ public:
      */
     void print() const;
 
+    /**
+     * @brief Przekazuje kolejne rekordy z zadanego przedziału dat do funkcji odwiedzającej.
+     * 
+     * Rekordy przekazywane są w kolejności chronologicznej jako `RecordView`, bez kopiowania
+     * i bez alokacji pamięci.
+     * 
+     * @param startDate Data początkowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param endDate Data końcowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param visitor Funkcja `void(const RecordView&)`.
+     * @return `false`, jeśli daty są niepoprawne.
+     */
+    template <typename Visitor>
+    bool forEachBetweenDates(const std::string& startDate, const std::string& endDate, Visitor&& visitor) const;
+
+    /**
+     * @brief Przekazuje do funkcji odwiedzającej rekordy z zadanego przedziału dat spełniające warunek.
+     * 
+     * @param startDate Data początkowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param endDate Data końcowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param predicate Warunek na wartościach kanałów.
+     * @param visitor Funkcja `void(const RecordView&)`.
+     * @return `false`, jeśli daty są niepoprawne.
+     */
+    template <typename Visitor>
+    bool forEachBetweenDates(const std::string& startDate, const std::string& endDate,
+        const Predicate& predicate, Visitor&& visitor) const;
+
+    /**
+     * @brief Przekazuje do funkcji odwiedzającej rekordy, których wartość kanału mieści się w tolerancji.
+     * 
+     * @param startDate Data początkowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param endDate Data końcowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param value Wartość do porównania.
+     * @param tolerance Tolerancja dla wartości.
+     * @param channel Przeszukiwany kanał.
+     * @param visitor Funkcja `void(const RecordView&)`.
+     * @return `false`, jeśli daty są niepoprawne.
+     */
+    template <typename Visitor>
+    bool forEachWithTolerance(const std::string& startDate, const std::string& endDate,
+        float value, float tolerance, Channel channel, Visitor&& visitor) const;
+
     /**
      * @brief Pobiera dane w zadanym przedziale dat.
      * 
      * Zwraca dane dotyczące energii w zadanym przedziale dat, uwzględniając kwartały, dni i miesiące.
+     * Kopiuje wszystkie rekordy; do przeglądania wyników bez kopiowania służy `forEachBetweenDates`.
+     * Miesiące dużych przedziałów przeglądane są równolegle (zob. `collectByMonths`).
      * 
      * @param startDate Data początkowa (w formacie "YYYY-MM-DD").
      * @param endDate Data końcowa (w formacie "YYYY-MM-DD").
@@ -94,6 +388,21 @@ public:
      */
     std::vector<LineData> getDataBetweenDates(const std::string& startDate, const std::string& endDate) const;
 
+    /**
+     * @brief Pobiera rekordy z zadanego przedziału dat spełniające warunek.
+     * 
+     * Lata, miesiące, dni i kwartały, których minima i maksima wykluczają spełnienie warunku,
+     * są pomijane bez przeglądania rekordów; w pozostałych kwartałach warunek sprawdzany jest kolumnami.
+     * Miesiące dużych przedziałów przeglądane są równolegle.
+     * 
+     * @param startDate Data początkowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param endDate Data końcowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param predicate Warunek na wartościach kanałów.
+     * @return Lista pasujących rekordów w kolejności chronologicznej.
+     */
+    std::vector<LineData> getDataBetweenDates(const std::string& startDate, const std::string& endDate,
+        const Predicate& predicate) const;
+
     /**
      * @brief Oblicza sumy wartości dla różnych typów danych w zadanym przedziale dat.
      * 
@@ -126,6 +435,77 @@ public:
     void calculateAveragesBetweenDates(const std::string& startDate, const std::string& endDate, 
         float& autokonsumpcjaAvg, float& eksportAvg, float& importAvg, float& poborAvg, float& produkcjaAvg) const;
 
+    /**
+     * @brief Zwraca agregaty (sumy, liczność, minima, maksima) w zadanym przedziale dat.
+     * 
+     * Całkowicie pokryte lata, miesiące, dni i kwartały są łączone z gotowych agregatów węzłów,
+     * a rekordy przeglądane są tylko w kwartałach częściowo pokrytych na krańcach przedziału.
+     * 
+     * @param startDate Data początkowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param endDate Data końcowa (w formacie "dd.mm.yyyy hh:mm").
+     * @return Agregaty rekordów z zadanego przedziału.
+     */
+    Aggregate aggregateBetweenDates(const std::string& startDate, const std::string& endDate) const;
+
+    /**
+     * @brief Zwraca serię agregatów godzinowych, dobowych lub miesięcznych z zadanego przedziału dat.
+     *
+     * Przedziały leżące w całości w zakresie zapytania odczytywane są wprost z utrzymywanych przy
+     * wczytywaniu agregatów godzin, dni i miesięcy; rekordy przeglądane są tylko w przedziałach
+     * przyciętych przez krańce zakresu. Przedziały bez rekordów są pomijane.
+     *
+     * @param startDate Data początkowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param endDate Data końcowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param resolution Rozdzielczość serii.
+     * @return Punkty serii w kolejności chronologicznej.
+     */
+    std::vector<RollupPoint> rollupBetweenDates(const std::string& startDate, const std::string& endDate,
+        Resolution resolution) const;
+
+    /**
+     * @brief Wybiera najdrobniejszą rozdzielczość, dla której seria z przedziału ma najwyżej `maxPoints` punktów.
+     *
+     * Pozwala np. wykresowi dobrać rozdzielczość do szerokości okna. Gdy nawet seria miesięczna
+     * jest dłuższa, zwracane jest `RESOLUTION_MONTH`.
+     *
+     * @param startDate Data początkowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param endDate Data końcowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param maxPoints Największa dopuszczalna liczba punktów.
+     * @return Wybrana rozdzielczość.
+     */
+    static Resolution selectResolution(const std::string& startDate, const std::string& endDate, size_t maxPoints);
+
+    /**
+     * @brief Grupuje rekordy z przedziału dat w przedziały czasowe i wyznacza wybrane wartości kanałów.
+     *
+     * Wszystkie przedziały liczone są jednym uporządkowanym przejściem drzewa. Lata, miesiące, dni
+     * i godziny leżące w całości w zakresie zapytania dołączane są do przedziału z gotowych agregatów
+     * węzłów (rok dla `BUCKET_YEAR`, miesiąc dla `BUCKET_MONTH`, doba dla `BUCKET_DAY` i `BUCKET_WEEK`,
+     * godzina dla `BUCKET_HOUR`); rekordy przeglądane są tylko na krańcach zakresu oraz dla kwadransów.
+     * Przedziały bez rekordów są pomijane.
+     *
+     * @param startDate Data początkowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param endDate Data końcowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param groupBy Długość przedziału, kanały i funkcje wyników.
+     * @return Wiersze wyników w kolejności chronologicznej.
+     */
+    std::vector<GroupRow> groupBetweenDates(const std::string& startDate, const std::string& endDate,
+        const GroupBy& groupBy) const;
+
+    /**
+     * @brief Zwraca agregaty rekordów z zadanego przedziału dat spełniających warunek.
+     * 
+     * Węzły, których wszystkie rekordy spełniają warunek, są łączone z gotowych agregatów,
+     * a węzły wykluczone przez minima i maksima są pomijane.
+     * 
+     * @param startDate Data początkowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param endDate Data końcowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param predicate Warunek na wartościach kanałów.
+     * @return Agregaty pasujących rekordów.
+     */
+    Aggregate aggregateBetweenDates(const std::string& startDate, const std::string& endDate,
+        const Predicate& predicate) const;
+
     /**
      * @brief Porównuje dane pomiędzy dwoma przedziałami dat.
      * 
@@ -149,28 +529,327 @@ public:
     /**
      * @brief Serializuje dane TreeData do pliku.
      * 
-     * Zapisuje całą strukturę TreeData do pliku binarnego.
+     * Zapisuje całą strukturę TreeData do pliku binarnego w formacie migawki (zob. `Snapshot`).
      * 
      * @param out Strumień wyjściowy do zapisu danych.
+     * @param compressed Czy kompresować kolumny (delta-of-delta i XOR).
+     * @throws std::runtime_error Jeśli zapis się nie powiódł.
+     */
+    void serialize(std::ofstream& out, bool compressed = false) const;
+
+    /**
+     * @brief Wczytuje dane z pliku binarnego zapisanego przez `serialize`.
+     * 
+     * Rekordy z pliku są dodawane do bieżącej zawartości drzewa.
+     * 
+     * @param in Strumień wejściowy z danymi binarnymi.
+     * @throws std::runtime_error Jeśli plik jest uszkodzony lub ma nieobsługiwany format.
      */
-    void serialize(std::ofstream& out) const;
+    void deserialize(std::ifstream& in);
 
     /**
      * @brief Wyszukuje rekordy z tolerancją dla wartości w zadanym przedziale dat.
      * 
-     * Wyszukuje dane w zadanym przedziale dat, gdzie różnice między wartościami są mniejsze niż zadana tolerancja.
+     * Wyszukuje dane w zadanym przedziale dat, gdzie różnice między wartościami wybranego kanału
+     * a zadaną wartością nie przekraczają tolerancji. Węzły, których minimum i maksimum kanału
+     * wykluczają dopasowanie, są pomijane, a w kwartałach używany jest indeks wartości.
+     * Miesiące dużych przedziałów przeszukiwane są równolegle.
      * 
-     * @param startDate Data początkowa (w formacie "YYYY-MM-DD").
-     * @param endDate Data końcowa (w formacie "YYYY-MM-DD").
+     * @param startDate Data początkowa (w formacie "dd.mm.yyyy hh:mm").
+     * @param endDate Data końcowa (w formacie "dd.mm.yyyy hh:mm").
      * @param value Wartość do porównania.
      * @param tolerance Tolerancja dla wartości.
-     * @return Lista rekordów, które pasują do kryteriów wyszukiwania.
+     * @param channel Przeszukiwany kanał.
+     * @return Lista rekordów, które pasują do kryteriów wyszukiwania, w kolejności chronologicznej.
      */
     std::vector<LineData> searchRecordsWithTolerance(const std::string& startDate, const std::string& endDate, 
-        float value, float tolerance) const;
+        float value, float tolerance, Channel channel = AUTOKONSUMPCJA) const;
 
 private:
-    std::map<int, YearNode> years; /**< Mapa lat przechowująca całą strukturę danych. */
+    /**
+     * @brief Agreguje rekordy z przedziału [start, end], łącząc agregaty całkowicie pokrytych węzłów.
+     * @param start Początek przedziału (znacznik czasu).
+     * @param end Koniec przedziału (znacznik czasu).
+     * @return Agregaty rekordów z przedziału.
+     */
+    Aggregate aggregateBetween(int64_t start, int64_t end) const;
+
+    /**
+     * @brief Zwraca agregaty przedziałów czasowych z przedziału [start, end] w kolejności chronologicznej.
+     * @param start Początek przedziału (znacznik czasu).
+     * @param end Koniec przedziału (znacznik czasu).
+     * @param bucket Długość przedziałów.
+     * @return Punkty serii dla przedziałów zawierających rekordy.
+     */
+    std::vector<RollupPoint> groupBetween(int64_t start, int64_t end, BucketSize bucket) const;
+
+    /**
+     * @brief Przechodzi drzewo, odwiedzając wyłącznie węzły nachodzące na przedział [start, end].
+     *
+     * Na każdym poziomie wybierane są tylko te zajęte pozycje tablic, które leżą w przedziale. Węzły leżące
+     * w całości wewnątrz przedziału są najpierw przekazywane do `onCovered`; jeśli zwróci `true`,
+     * węzeł uznaje się za obsłużony i nie jest rozwijany. W kwartałach na krańcach przedziału tak samo
+     * traktowane są agregaty pełnych godzin. Dla pozostałych rekordów wywoływane jest `onRange`
+     * z zakresami indeksów [begin, end) w kolejności chronologicznej.
+     *
+     * @param start Początek przedziału (znacznik czasu).
+     * @param end Koniec przedziału (znacznik czasu).
+     * @param onCovered Funkcja `bool(const Aggregate&)` wywoływana dla całkowicie pokrytych węzłów.
+     * @param onRange Funkcja `void(const QuarterNode&, size_t, size_t)` wywoływana dla zakresów rekordów.
+     */
+    template <typename CoveredFn, typename RangeFn>
+    void descendBetween(int64_t start, int64_t end, CoveredFn&& onCovered, RangeFn&& onRange) const;
+
+    /**
+     * @brief Przekazuje do funkcji odwiedzającej rekordy z przedziału [start, end] (zob. `forEachBetweenDates`).
+     */
+    template <typename Visitor>
+    void visitBetween(int64_t start, int64_t end, Visitor&& visitor) const;
+
+    /**
+     * @brief Przekazuje do funkcji odwiedzającej rekordy z przedziału [start, end] spełniające warunek.
+     */
+    template <typename Visitor>
+    void visitBetween(int64_t start, int64_t end, const Predicate& predicate, Visitor&& visitor) const;
+
+    /**
+     * @brief Przekazuje do funkcji odwiedzającej rekordy z przedziału [start, end] z wartością kanału w tolerancji.
+     */
+    template <typename Visitor>
+    void visitWithTolerance(int64_t start, int64_t end,
+        float value, float tolerance, Channel channel, Visitor&& visitor) const;
+
+    /**
+     * @brief Zbiera rekordy z przedziału [start, end], przetwarzając jego miesiące równolegle.
+     *
+     * Przedział dzielony jest na części należące do kolejnych miesięcy z rekordami, a części są
+     * rozdzielane między wątki wspólnej puli (`ThreadPool::forEachIndex`). Wyniki części łączone są
+     * w kolejności miesięcy, więc lista jest taka sama jak przy przejściu jednym wątkiem. Małe
+     * przedziały przetwarzane są w wątku wywołującym.
+     *
+     * @param start Początek przedziału (znacznik czasu).
+     * @param end Koniec przedziału (znacznik czasu).
+     * @param collect Funkcja `void(int64_t, int64_t, std::vector<LineData>&)` zbierająca rekordy części przedziału.
+     * @return Rekordy w kolejności chronologicznej.
+     */
+    template <typename Collect>
+    std::vector<LineData> collectByMonths(int64_t start, int64_t end, Collect&& collect) const;
+
+    /**
+     * @brief Obsługuje rekord o znaczniku czasu, który już istnieje w dniu, zgodnie z polityką duplikatów.
+     * @return `true`, jeśli rekord należy mimo to dodać (`DUPLICATE_KEEP`).
+     */
+    bool handleDuplicate(YearNode& yearNode, MonthNode& monthNode, DayNode& dayNode, QuarterNode& quarterNode,
+        int64_t timestamp, const float values[CHANNEL_COUNT]);
+
+    /**
+     * @brief Zwraca węzeł roku do zapisu, tworząc go (i rozszerzając katalog lat) w razie potrzeby.
+     *
+     * Węzeł współdzielony z inną kopią drzewa jest najpierw kopiowany (bez kopiowania miesięcy).
+     */
+    YearNode& yearAt(int year);
+
+    /**
+     * @brief Zwraca węzeł miesiąca do zapisu, tworząc go w razie potrzeby.
+     *
+     * Miesiąc współdzielony z inną kopią drzewa jest najpierw kopiowany wraz z kolumnami do areny drzewa.
+     */
+    MonthNode& monthAt(YearNode& yearNode, int month);
+
+    /**
+     * @brief Zwraca węzeł roku lub `nullptr`, jeśli w roku nie ma rekordów.
+     */
+    const YearNode* findYear(int year) const;
+
+    /**
+     * @brief Zwraca węzeł kwartału, przełączając nowo zajęty kwartał na alokację z areny.
+     */
+    QuarterNode& quarterAt(DayNode& dayNode, int quarter);
+
+    /**
+     * @struct Arena
+     * @brief Pamięć kolumn drzewa: pula bloków o stałych rozmiarach nad buforem monotonicznym.
+     *
+     * Bufor monotoniczny przydziela pamięć przesunięciem wskaźnika, a pula ponownie wykorzystuje
+     * bloki zwalniane przy powiększaniu kolumn, więc wzrost wektorów nie marnuje pamięci bufora.
+     * Pula jest synchronizowana, bo miesiące starej wersji drzewa zwalnia wątek, który ją czytał.
+     */
+    struct Arena {
+        Arena();
+
+        std::pmr::monotonic_buffer_resource buffer; /**< Źródło pamięci zwalniane w całości. */
+        std::pmr::synchronized_pool_resource pool; /**< Pula bloków przydzielanych z `buffer`. */
+    };
+
+    std::shared_ptr<Arena> arena; /**< Arena kolumn współdzielona z kopiami drzewa; niszczona po `years`. */
+    std::vector<std::shared_ptr<YearNode>> years; /**< Katalog lat: pozycja `rok - firstYear`, `nullptr` dla lat bez rekordów. */
+    int firstYear = 0; /**< Rok pierwszej pozycji katalogu lat. */
+    DuplicatePolicy duplicatePolicy = DUPLICATE_SKIP; /**< Sposób obsługi duplikatów. */
+    size_t duplicateCount = 0; /**< Liczba wykrytych duplikatów. */
 };
 
+template <typename Visitor>
+bool TreeData::forEachBetweenDates(const std::string& startDate, const std::string& endDate, Visitor&& visitor) const {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return false;
+    }
+    visitBetween(start, end, visitor);
+    return true;
+}
+
+template <typename Visitor>
+bool TreeData::forEachBetweenDates(const std::string& startDate, const std::string& endDate,
+    const Predicate& predicate, Visitor&& visitor) const {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return false;
+    }
+    visitBetween(start, end, predicate, visitor);
+    return true;
+}
+
+template <typename Visitor>
+bool TreeData::forEachWithTolerance(const std::string& startDate, const std::string& endDate,
+    float value, float tolerance, Channel channel, Visitor&& visitor) const {
+    int64_t start, end;
+    if (!parseTimestamp(startDate, start) || !parseTimestamp(endDate, end)) {
+        return false;
+    }
+    visitWithTolerance(start, end, value, tolerance, channel, visitor);
+    return true;
+}
+
+template <typename Visitor>
+void TreeData::visitBetween(int64_t start, int64_t end, Visitor&& visitor) const {
+    descendBetween(start, end,
+        [](const Aggregate&) { return false; },
+        [&visitor](const QuarterNode& quarterNode, size_t begin, size_t finish) {
+            const float* columns[CHANNEL_COUNT];
+            quarterNode.getColumns(columns);
+            for (size_t i = begin; i < finish; ++i) {
+                visitor(RecordView(quarterNode.timestamps[i], columns, i));
+            }
+        });
+}
+
+template <typename Visitor>
+void TreeData::visitBetween(int64_t start, int64_t end, const Predicate& predicate, Visitor&& visitor) const {
+    std::vector<uint8_t> mask, scratch;
+    descendBetween(start, end,
+        [&predicate](const Aggregate& aggregate) { return !predicate.mayMatch(aggregate); },
+        [&](const QuarterNode& quarterNode, size_t begin, size_t finish) {
+            const float* columns[CHANNEL_COUNT];
+            quarterNode.getColumns(columns);
+            predicate.evaluate(columns, begin, finish, mask, scratch);
+            for (size_t i = begin; i < finish; ++i) {
+                if (mask[i - begin]) {
+                    visitor(RecordView(quarterNode.timestamps[i], columns, i));
+                }
+            }
+        });
+}
+
+template <typename Visitor>
+void TreeData::visitWithTolerance(int64_t start, int64_t end,
+    float value, float tolerance, Channel channel, Visitor&& visitor) const {
+    float low = value - tolerance;
+    float high = value + tolerance;
+    std::vector<uint32_t> positions;
+    descendBetween(start, end,
+        [channel, low, high](const Aggregate& aggregate) {
+            return aggregate.max[channel] < low || aggregate.min[channel] > high;
+        },
+        [&](const QuarterNode& quarterNode, size_t begin, size_t finish) {
+            const float* columns[CHANNEL_COUNT];
+            quarterNode.getColumns(columns);
+            positions.clear();
+            quarterNode.findValues(channel, low, high, begin, finish, positions);
+            for (uint32_t position : positions) {
+                visitor(RecordView(quarterNode.timestamps[position], columns, position));
+            }
+        });
+}
+
+template <typename CoveredFn, typename RangeFn>
+void TreeData::descendBetween(int64_t start, int64_t end, CoveredFn&& onCovered, RangeFn&& onRange) const {
+    if (start > end) {
+        return;
+    }
+
+    int startYear, startMonth, startDay, startHour, startMinute;
+    int endYear, endMonth, endDay, endHour, endMinute;
+    splitTimestamp(start, startYear, startMonth, startDay, startHour, startMinute);
+    splitTimestamp(end, endYear, endMonth, endDay, endHour, endMinute);
+    int startQuarter = (startHour * 60 + startMinute) / 360;
+    int endQuarter = (endHour * 60 + endMinute) / 360;
+
+    int lastYear = std::min(endYear, firstYear + static_cast<int>(years.size()) - 1);
+    for (int year = std::max(startYear, firstYear); year <= lastYear; ++year) {
+        const YearNode* yearNode = findYear(year);
+        if (yearNode == nullptr) {
+            continue;
+        }
+        bool yearLow = year == startYear;
+        bool yearHigh = year == endYear;
+        if (!yearLow && !yearHigh && onCovered(yearNode->aggregate)) {
+            continue;
+        }
+
+        for (const auto& monthSlot : yearNode->months.range(yearLow ? startMonth : 1, yearHigh ? endMonth : 12)) {
+            const MonthNode& monthNode = *monthSlot;
+            bool monthLow = yearLow && monthNode.month == startMonth;
+            bool monthHigh = yearHigh && monthNode.month == endMonth;
+            if (!monthLow && !monthHigh && onCovered(monthNode.aggregate)) {
+                continue;
+            }
+
+            for (const DayNode& dayNode : monthNode.days.range(monthLow ? startDay : 1, monthHigh ? endDay : 31)) {
+                bool dayLow = monthLow && dayNode.day == startDay;
+                bool dayHigh = monthHigh && dayNode.day == endDay;
+                if (!dayLow && !dayHigh && onCovered(dayNode.aggregate)) {
+                    continue;
+                }
+
+                for (const QuarterNode& quarterNode : dayNode.quarters.range(dayLow ? startQuarter : 0, dayHigh ? endQuarter : 3)) {
+                    bool quarterLow = dayLow && quarterNode.quarter == startQuarter;
+                    bool quarterHigh = dayHigh && quarterNode.quarter == endQuarter;
+                    if (!quarterLow && !quarterHigh) {
+                        if (!onCovered(quarterNode.aggregate)) {
+                            onRange(quarterNode, size_t(0), quarterNode.size());
+                        }
+                        continue;
+                    }
+
+                    const auto& timestamps = quarterNode.timestamps;
+                    size_t begin = quarterLow
+                        ? std::lower_bound(timestamps.begin(), timestamps.end(), start) - timestamps.begin() : 0;
+                    size_t finish = quarterHigh
+                        ? std::upper_bound(timestamps.begin(), timestamps.end(), end) - timestamps.begin() : timestamps.size();
+
+                    // Pełne godziny wewnątrz przedziału przekazywane są jako agregaty, a rekordy pozostałych
+                    // godzin łączone w możliwie długie zakresy
+                    size_t pending = begin;
+                    for (size_t position = begin; position < finish;) {
+                        int64_t hourStart = timestamps[position] - (timestamps[position] % 60 + 60) % 60;
+                        size_t hourEnd = std::lower_bound(timestamps.begin() + position, timestamps.begin() + finish,
+                            hourStart + 60) - timestamps.begin();
+                        if (hourStart >= start && hourStart + 59 <= end
+                            && onCovered(quarterNode.hours[QuarterNode::hourSlot(hourStart)])) {
+                            if (pending < position) {
+                                onRange(quarterNode, pending, position);
+                            }
+                            pending = hourEnd;
+                        }
+                        position = hourEnd;
+                    }
+                    if (pending < finish) {
+                        onRange(quarterNode, pending, finish);
+                    }
+                }
+            }
+        }
+    }
+}
+
 #endif
@@ -0,0 +1,18 @@
+/**
+ * @file treeStore.cpp
+ * @brief Implementacja klasy `TreeStore`.
+ */
+
+#include "treeStore.hpp"
+
+TreeStore::TreeStore() : current(std::make_shared<const TreeData>()) {}
+
+std::shared_ptr<const TreeData> TreeStore::snapshot() const {
+    return std::atomic_load(&current);
+}
+
+void TreeStore::publish(TreeData&& treeData) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    std::atomic_store(&current, std::shared_ptr<const TreeData>(std::make_shared<TreeData>(std::move(treeData))));
+    ++version;
+}
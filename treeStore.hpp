@@ -0,0 +1,85 @@
+/**
+ * @file treeStore.hpp
+ * @brief Deklaracja klasy `TreeStore` publikującej niezmienne wersje drzewa dla równoległych odczytów.
+ */
+
+#ifndef TREESTORE_HPP
+#define TREESTORE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "treeData.hpp"
+
+/**
+ * @class TreeStore
+ * @brief Przechowuje bieżącą wersję drzewa i zastępuje ją atomowo nowymi wersjami.
+ *
+ * Czytelnicy pobierają przez `snapshot` wskaźnik na niezmienną wersję drzewa i pracują na niej
+ * bez blokad tak długo, jak jej potrzebują. Zapis (`update`) zmienia kopię bieżącej wersji, która
+ * współdzieli z nią niezmienione lata i miesiące (zob. `TreeData`), i publikuje ją jednym atomowym
+ * podstawieniem wskaźnika. Wersja zwalniana jest razem z ostatnim czytelnikiem, który ją trzyma.
+ *
+ * Zapisy wykonywane są po kolei; czytelnicy nigdy nie czekają na zapis.
+ */
+class TreeStore {
+public:
+    /**
+     * @brief Tworzy magazyn z pustym drzewem jako wersją 0.
+     */
+    TreeStore();
+
+    TreeStore(const TreeStore&) = delete;
+    TreeStore& operator=(const TreeStore&) = delete;
+
+    /**
+     * @brief Zwraca bieżącą wersję drzewa.
+     *
+     * Zwrócona wersja nie zmienia się, nawet jeśli w tym czasie zostaną opublikowane kolejne.
+     */
+    std::shared_ptr<const TreeData> snapshot() const;
+
+    /**
+     * @brief Tworzy nową wersję drzewa przez zmianę kopii bieżącej wersji i publikuje ją.
+     *
+     * Wersja nie jest publikowana, jeśli funkcja zwróci `false` lub zgłosi wyjątek, więc czytelnicy
+     * widzą tylko kompletne wczytania.
+     *
+     * @param updater Funkcja `bool(TreeData&)` zmieniająca kopię drzewa.
+     * @return Wynik funkcji `updater`.
+     */
+    template <typename Updater>
+    bool update(Updater&& updater);
+
+    /**
+     * @brief Zastępuje bieżącą wersję podanym drzewem.
+     * @param treeData Nowa zawartość.
+     */
+    void publish(TreeData&& treeData);
+
+    /**
+     * @brief Zwraca numer bieżącej wersji (liczba opublikowanych zmian).
+     */
+    uint64_t getVersion() const { return version.load(); }
+
+private:
+    std::shared_ptr<const TreeData> current; /**< Bieżąca wersja (dostęp wyłącznie przez `std::atomic_load`/`std::atomic_store`). */
+    std::mutex writeMutex; /**< Szereguje zapisy. */
+    std::atomic<uint64_t> version{ 0 }; /**< Numer bieżącej wersji. */
+};
+
+template <typename Updater>
+bool TreeStore::update(Updater&& updater) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    auto next = std::make_shared<TreeData>(*snapshot());
+    if (!updater(*next)) {
+        return false;
+    }
+    std::atomic_store(&current, std::shared_ptr<const TreeData>(std::move(next)));
+    ++version;
+    return true;
+}
+
+#endif